@@ -1,10 +1,31 @@
 #include <iostream>
-#include <queue>
+#include <cstddef>
+#include <deque>
+#include <new>
+#include <exception>
+#include <iterator>
+#include <type_traits>
 #include <limits>
+#include <vector>
+#include <algorithm>
 using namespace std;
 
-template <typename T>
-class Node
+// The AVL height of a subtree, which only the nodes of balanced trees carry; for the
+// others the empty base takes no space.
+template <bool levelled>
+class NodeLevel
+{
+};
+
+template <>
+class NodeLevel<true>
+{
+public:
+    signed char level = 0;
+};
+
+template <typename T, bool levelled = false>
+class Node : public NodeLevel<levelled>
 {
 public:
     T data;
@@ -18,137 +39,579 @@ public:
     }
 };
 
-template <typename T>
-class BinaryTree
+// Node storage policies for BinaryTree. A policy decides how nodes are held and
+// addressed: Link is what a child field stores and none is the empty link. data(),
+// left(), right() and level() reach into a node, create() and destroy() hand out and
+// take back nodes, and releaseAll() is called by clear() once every node has been
+// destroyed, or right away without destroying them one by one when the policy sets
+// releasesAll and T has a trivial destructor. Only policies with keepsLevels set can
+// back a balanced tree.
+
+// node access shared by the policies that address nodes by pointer
+template <typename T, bool levelled>
+class PointerNodes
+{
+public:
+    typedef Node<T, levelled> *Link;
+    static constexpr Link none = nullptr;
+    static const bool keepsLevels = levelled;
+
+    T &data(Link node) { return node->data; }
+    const T &data(Link node) const { return node->data; }
+    Link &left(Link node) { return node->left; }
+    Link left(Link node) const { return node->left; }
+    Link &right(Link node) { return node->right; }
+    Link right(Link node) const { return node->right; }
+    signed char &level(Link node) { return node->level; }
+    signed char level(Link node) const { return node->level; }
+};
+
+// every node is its own new / delete
+template <typename T, bool levelled = false>
+class NodeHeap : public PointerNodes<T, levelled>
+{
+public:
+    static const bool releasesAll = false;
+
+    Node<T, levelled> *create(const T &value)
+    {
+        return new Node<T, levelled>(value);
+    }
+
+    void destroy(Node<T, levelled> *node)
+    {
+        delete node;
+    }
+
+    void releaseAll() {}
+};
+
+// Nodes are carved out of slabs, so a tree's nodes sit next to each other in memory.
+// Slabs start at 256 nodes and double up to 64K nodes. Destroyed nodes go on a free
+// list that create() takes from first; releaseAll() hands every slab back at once,
+// which costs one free per slab rather than one per node. An arena belongs to one tree
+// and cannot be copied.
+template <typename T, bool levelled = false>
+class NodeArena : public PointerNodes<T, levelled>
 {
 private:
-    Node<T> *root;
+    union Slot
+    {
+        Slot *next; // while on the free list
+        alignas(Node<T, levelled>) unsigned char node[sizeof(Node<T, levelled>)];
+    };
+
+    static const size_t firstSlab = 256;
+    static const size_t largestSlab = 1 << 16;
+
+    vector<Slot *> slabs;
+    Slot *freeList;
+    Slot *cursor; // next unused slot in the newest slab
+    Slot *slabEnd;
+    size_t slabSize;
 
-    Node<T> *insert(Node<T> *node, T value)
+    static size_t nextSlab(size_t size)
     {
-        if (node == nullptr)
-            return new Node<T>(value);
+        return 2 * size < largestSlab ? 2 * size : largestSlab;
+    }
 
-        if (value < node->data)
-            node->left = insert(node->left, value);
-        else
-            node->right = insert(node->right, value);
+    void grow()
+    {
+        slabSize = slabs.empty() ? firstSlab : nextSlab(slabSize);
+        Slot *slab = (Slot *)::operator new(slabSize * sizeof(Slot), align_val_t(alignof(Slot)));
+        slabs.push_back(slab);
+        cursor = slab;
+        slabEnd = slab + slabSize;
+    }
+
+public:
+    static const bool releasesAll = true;
+
+    NodeArena() : freeList(nullptr), cursor(nullptr), slabEnd(nullptr), slabSize(0) {}
 
-        return node;
+    NodeArena(const NodeArena &) = delete;
+    NodeArena &operator=(const NodeArena &) = delete;
+
+    ~NodeArena()
+    {
+        releaseAll();
     }
 
-    void inorder(Node<T> *node)
+    Node<T, levelled> *create(const T &value)
     {
-        if (node != nullptr)
+        Slot *slot = freeList;
+        if (slot != nullptr)
+            freeList = slot->next;
+        else
         {
-            inorder(node->left);
-            cout << node->data << " ";
-            inorder(node->right);
+            if (cursor == slabEnd)
+                grow();
+            slot = cursor++;
         }
+        return new (slot->node) Node<T, levelled>(value);
     }
 
-    void preorder(Node<T> *node)
+    void destroy(Node<T, levelled> *node)
     {
-        if (node != nullptr)
-        {
-            cout << node->data << " ";
-            preorder(node->left);
-            preorder(node->right);
-        }
+        node->~Node<T, levelled>();
+        Slot *slot = (Slot *)(void *)node;
+        slot->next = freeList;
+        freeList = slot;
     }
 
-    void postorder(Node<T> *node)
+    void releaseAll()
     {
-        if (node != nullptr)
+        for (Slot *slab : slabs)
+            ::operator delete((void *)slab, align_val_t(alignof(Slot)));
+        slabs.clear();
+        freeList = cursor = slabEnd = nullptr;
+        slabSize = 0;
+    }
+
+    // bytes held in slabs, used or not
+    size_t bytes() const
+    {
+        size_t total = 0, size = firstSlab;
+        for (size_t i = 0; i < slabs.size(); i++, size = nextSlab(size))
+            total += size * sizeof(Slot);
+        return total;
+    }
+};
+
+// Binary search tree; equal values go to the right.
+// With balanced = true it is an AVL tree: after every insert and remove the nodes on
+// the way back up are rotated so that sibling subtrees differ in height by at most
+// one, which keeps the height below 1.45 log2(n) whatever order the keys arrive in.
+// Only balanced trees give their nodes the height byte. For a 4-byte key like int it
+// fits in the padding after the key (24 bytes a node either way); for an 8-byte key it
+// grows a node from 24 to 32 bytes.
+// Nodes come from the Storage policy: NodeHeap (new / delete per node) by default,
+// NodeArena for slab allocation and a clear() that does not walk the tree, or
+// IndexNodes (CompactBinaryTree.cpp) for one vector of nodes linked by 32-bit index.
+// A balanced tree needs its storage to keep levels, e.g. NodeArena<T, true>.
+template <typename T, bool balanced = false, typename Storage = NodeHeap<T, balanced>>
+class BinaryTree
+{
+private:
+    static_assert(!balanced || Storage::keepsLevels, "a balanced BinaryTree needs storage that keeps levels");
+
+    typedef typename Storage::Link Link;
+
+    Link root;
+    Storage nodes;
+
+    int level(Link node) const
+    {
+        return node == Storage::none ? -1 : nodes.level(node);
+    }
+
+    void update(Link node)
+    {
+        nodes.level(node) = (signed char)(1 + max(level(nodes.left(node)), level(nodes.right(node))));
+    }
+
+    Link rotateRight(Link node)
+    {
+        Link pivot = nodes.left(node);
+        nodes.left(node) = nodes.right(pivot);
+        nodes.right(pivot) = node;
+        update(node);
+        update(pivot);
+        return pivot;
+    }
+
+    Link rotateLeft(Link node)
+    {
+        Link pivot = nodes.right(node);
+        nodes.right(node) = nodes.left(pivot);
+        nodes.left(pivot) = node;
+        update(node);
+        update(pivot);
+        return pivot;
+    }
+
+    // restores the AVL invariant at node once both subtrees satisfy it
+    Link rebalance(Link node)
+    {
+        if constexpr (!balanced)
+            return node;
+        else
         {
-            postorder(node->left);
-            postorder(node->right);
-            cout << node->data << " ";
+            update(node);
+            Link left = nodes.left(node), right = nodes.right(node);
+            int balance = level(left) - level(right);
+            if (balance > 1)
+            {
+                if (level(nodes.left(left)) < level(nodes.right(left)))
+                    nodes.left(node) = rotateLeft(left);
+                return rotateRight(node);
+            }
+            if (balance < -1)
+            {
+                if (level(nodes.right(right)) < level(nodes.left(right)))
+                    nodes.right(node) = rotateRight(right);
+                return rotateLeft(node);
+            }
+            return node;
         }
     }
 
-    void levelOrder(Node<T> *node)
+    // create() may move the storage (IndexNodes), so no reference into it is held across the call
+    Link insert(Link node, T value)
     {
-        if (node == nullptr)
-            return;
+        if (node == Storage::none)
+            return nodes.create(value);
 
-        queue<Node<T> *> q;
-        q.push(node);
+        if (value < nodes.data(node))
+        {
+            Link child = insert(nodes.left(node), value);
+            nodes.left(node) = child;
+        }
+        else
+        {
+            Link child = insert(nodes.right(node), value);
+            nodes.right(node) = child;
+        }
 
-        while (!q.empty())
+        return rebalance(node);
+    }
+
+    Link removeMin(Link node, T &minimum)
+    {
+        if (nodes.left(node) == Storage::none)
         {
-            Node<T> *current = q.front();
-            q.pop();
+            Link right = nodes.right(node);
+            minimum = nodes.data(node);
+            nodes.destroy(node);
+            return right;
+        }
+        nodes.left(node) = removeMin(nodes.left(node), minimum);
+        return rebalance(node);
+    }
 
-            cout << current->data << " ";
+    Link remove(Link node, const T &value, bool &removed)
+    {
+        if (node == Storage::none)
+            return Storage::none;
 
-            if (current->left != nullptr)
-                q.push(current->left);
-            if (current->right != nullptr)
-                q.push(current->right);
+        if (value < nodes.data(node))
+            nodes.left(node) = remove(nodes.left(node), value, removed);
+        else if (nodes.data(node) < value)
+            nodes.right(node) = remove(nodes.right(node), value, removed);
+        else
+        {
+            removed = true;
+            Link left = nodes.left(node), right = nodes.right(node);
+            if (left == Storage::none || right == Storage::none)
+            {
+                nodes.destroy(node);
+                return left != Storage::none ? left : right;
+            }
+            // two children: the smallest key on the right takes this node's place
+            nodes.right(node) = removeMin(right, nodes.data(node));
         }
+        return rebalance(node);
     }
 
-    int height(Node<T> *node)
+    int height(Link node)
     {
-        if (node == nullptr)
+        if (node == Storage::none)
             return -1;
-        int leftHeight = height(node->left);
-        int rightHeight = height(node->right);
+        int leftHeight = height(nodes.left(node));
+        int rightHeight = height(nodes.right(node));
         return 1 + max(leftHeight, rightHeight);
     }
 
-    int countLeaves(Node<T> *node)
+    int countLeaves(Link node)
     {
-        if (node == nullptr)
+        if (node == Storage::none)
             return 0;
-        if (node->left == nullptr && node->right == nullptr)
+        if (nodes.left(node) == Storage::none && nodes.right(node) == Storage::none)
             return 1;
-        return countLeaves(node->left) + countLeaves(node->right);
+        return countLeaves(nodes.left(node)) + countLeaves(nodes.right(node));
     }
 
-    int countNodes(Node<T> *node)
+    int countNodes(Link node)
     {
-        if (node == nullptr)
+        if (node == Storage::none)
             return 0;
-        return 1 + countNodes(node->left) + countNodes(node->right);
+        return 1 + countNodes(nodes.left(node)) + countNodes(nodes.right(node));
     }
 
-    void deleteTree(Node<T> *node)
+    void deleteTree(Link node)
     {
-        if (node == nullptr)
+        if (node == Storage::none)
             return;
-        deleteTree(node->left);
-        deleteTree(node->right);
-        delete node;
+        deleteTree(nodes.left(node));
+        deleteTree(nodes.right(node));
+        nodes.destroy(node);
     }
 
-    T findMaxInBinaryTree(Node<T> *node)
+    T findMaxInBinaryTree(Link node)
     {
-        if (node == nullptr)
+        if (node == Storage::none)
             return numeric_limits<T>::lowest();
 
-        T current = node->data;
-        T leftMax = findMaxInBinaryTree(node->left);
-        T rightMax = findMaxInBinaryTree(node->right);
+        T current = nodes.data(node);
+        T leftMax = findMaxInBinaryTree(nodes.left(node));
+        T rightMax = findMaxInBinaryTree(nodes.right(node));
 
         return max(current, max(leftMax, rightMax));
     }
 
-    bool identical(Node *Node1, Node *Node2)
+    bool identical(Link node1, const BinaryTree &other, Link node2)
     {
-        if (node1 == nullptr && node2 == nullptr)
+        if (node1 == Storage::none && node2 == Storage::none)
             return true;
-        if (node1 != nullptr &&node2 1 = nullptr)
-            return (node1->data == node2->data) && identical(node1->left, node2->left) && identical(node1->right, node2->right);
+        if (node1 != Storage::none && node2 != Storage::none)
+            return (nodes.data(node1) == other.nodes.data(node2)) &&
+                   identical(nodes.left(node1), other, other.nodes.left(node2)) &&
+                   identical(nodes.right(node1), other, other.nodes.right(node2));
 
         return false;
     }
 
+    // visits [lo, hi] in order, skipping subtrees that lie wholly outside it
+    template <typename F>
+    void range(Link node, const T &lo, const T &hi, F &visit) const
+    {
+        while (node != Storage::none)
+        {
+            if (nodes.data(node) < lo)
+                node = nodes.right(node);
+            else if (hi < nodes.data(node))
+                node = nodes.left(node);
+            else
+            {
+                range(nodes.left(node), lo, hi, visit);
+                visit(nodes.data(node));
+                node = nodes.right(node);
+            }
+        }
+    }
+
+    // resolves the sorted probes [first, last) below node; probes that take the same
+    // path share it, so each node is visited once per batch
+    void findBatch(Link node, const T *probes, size_t first, size_t last, const T **out) const
+    {
+        while (first < last)
+        {
+            if (node == Storage::none)
+            {
+                for (size_t i = first; i < last; i++)
+                    out[i] = nullptr;
+                return;
+            }
+            const T &data = nodes.data(node);
+            size_t low = std::lower_bound(probes + first, probes + last, data) - probes;
+            size_t high = std::upper_bound(probes + low, probes + last, data) - probes;
+            for (size_t i = low; i < high; i++)
+                out[i] = &data;
+            findBatch(nodes.left(node), probes, first, low, out);
+            first = high;
+            node = nodes.right(node);
+        }
+    }
+
 public:
+    enum Order
+    {
+        Inorder,
+        Preorder,
+        Postorder,
+        LevelOrder
+    };
+
+    // Forward iterator over the elements in one traversal order. The pending nodes are
+    // kept on the heap instead of the call stack: a vector used as a stack, at most the
+    // height of the tree, for the depth-first orders, and a deque holding at most the
+    // widest level for LevelOrder. The current element is at the back (the front for
+    // LevelOrder) and end() has nothing pending. Modifying the tree invalidates every
+    // iterator over it.
+    template <Order order>
+    class Iterator
+    {
+    private:
+        const Storage *nodes;
+        typename conditional<order == LevelOrder, deque<Link>, vector<Link>>::type pending;
+
+        // pushes node and its leftmost descendants
+        void pushLeft(Link node)
+        {
+            for (; node != Storage::none; node = nodes->left(node))
+                pending.push_back(node);
+        }
+
+        // pushes the path to the first node postorder visits below node
+        void pushFirstPostorder(Link node)
+        {
+            while (node != Storage::none)
+            {
+                pending.push_back(node);
+                node = nodes->left(node) != Storage::none ? nodes->left(node) : nodes->right(node);
+            }
+        }
+
+        Link current() const
+        {
+            if (pending.empty())
+                return Storage::none;
+            if constexpr (order == LevelOrder)
+                return pending.front();
+            else
+                return pending.back();
+        }
+
+    public:
+        typedef forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        Iterator() : nodes(nullptr) {}
+
+        Iterator(const Storage *storage, Link root) : nodes(storage)
+        {
+            if (root == Storage::none)
+                return;
+            if (order == Inorder)
+                pushLeft(root);
+            else if (order == Postorder)
+                pushFirstPostorder(root);
+            else
+                pending.push_back(root);
+        }
+
+        reference operator*() const
+        {
+            return nodes->data(current());
+        }
+
+        pointer operator->() const
+        {
+            return &nodes->data(current());
+        }
+
+        Iterator &operator++()
+        {
+            if constexpr (order == LevelOrder)
+            {
+                Link node = pending.front();
+                pending.pop_front();
+                if (nodes->left(node) != Storage::none)
+                    pending.push_back(nodes->left(node));
+                if (nodes->right(node) != Storage::none)
+                    pending.push_back(nodes->right(node));
+            }
+            else
+            {
+                Link node = pending.back();
+                pending.pop_back();
+                if (order == Inorder)
+                    pushLeft(nodes->right(node));
+                else if (order == Preorder)
+                {
+                    if (nodes->right(node) != Storage::none)
+                        pending.push_back(nodes->right(node));
+                    if (nodes->left(node) != Storage::none)
+                        pending.push_back(nodes->left(node));
+                }
+                // postorder: after a left child comes the right subtree, if any, then the parent
+                else if (!pending.empty() && nodes->left(pending.back()) == node)
+                    pushFirstPostorder(nodes->right(pending.back()));
+            }
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator before = *this;
+            ++*this;
+            return before;
+        }
+
+        bool operator==(const Iterator &other) const
+        {
+            return current() == other.current();
+        }
+
+        bool operator!=(const Iterator &other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    // begin() and end() of one traversal, for range-for and the STL algorithms
+    template <Order order>
+    class Traversal
+    {
+    private:
+        const Storage *nodes;
+        Link root;
+
+    public:
+        Traversal(const Storage *storage, Link node) : nodes(storage), root(node) {}
+
+        Iterator<order> begin() const
+        {
+            return Iterator<order>(nodes, root);
+        }
+
+        Iterator<order> end() const
+        {
+            return Iterator<order>();
+        }
+    };
+
+    typedef Iterator<Inorder> const_iterator;
+    typedef const_iterator iterator;
+
     BinaryTree()
     {
-        root = nullptr;
+        root = Storage::none;
+    }
+
+    // makes room for n nodes in total, for storage that can reserve (IndexNodes)
+    void reserve(size_t n)
+    {
+        nodes.reserve(n);
+    }
+
+    // bytes held by the node storage, for storage that keeps count (NodeArena, IndexNodes)
+    size_t bytes() const
+    {
+        return nodes.bytes();
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(&nodes, root);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator();
+    }
+
+    Traversal<Inorder> inorder() const
+    {
+        return Traversal<Inorder>(&nodes, root);
+    }
+
+    Traversal<Preorder> preorder() const
+    {
+        return Traversal<Preorder>(&nodes, root);
+    }
+
+    Traversal<Postorder> postorder() const
+    {
+        return Traversal<Postorder>(&nodes, root);
+    }
+
+    Traversal<LevelOrder> levelOrder() const
+    {
+        return Traversal<LevelOrder>(&nodes, root);
     }
 
     void insert(T value)
@@ -156,29 +619,226 @@ public:
         root = insert(root, value);
     }
 
+    bool contains(const T &value) const
+    {
+        return find(value) != nullptr;
+    }
+
+    // the stored element equal to value, or nullptr
+    const T *find(const T &value) const
+    {
+        Link node = root;
+        while (node != Storage::none)
+        {
+            if (value < nodes.data(node))
+                node = nodes.left(node);
+            else if (nodes.data(node) < value)
+                node = nodes.right(node);
+            else
+                return &nodes.data(node);
+        }
+        return nullptr;
+    }
+
+    // the smallest element not less than value, or nullptr
+    const T *lower_bound(const T &value) const
+    {
+        const T *best = nullptr;
+        for (Link node = root; node != Storage::none;)
+        {
+            if (nodes.data(node) < value)
+                node = nodes.right(node);
+            else
+            {
+                best = &nodes.data(node);
+                node = nodes.left(node);
+            }
+        }
+        return best;
+    }
+
+    // the smallest element greater than value, or nullptr
+    const T *upper_bound(const T &value) const
+    {
+        const T *best = nullptr;
+        for (Link node = root; node != Storage::none;)
+        {
+            if (value < nodes.data(node))
+            {
+                best = &nodes.data(node);
+                node = nodes.left(node);
+            }
+            else
+                node = nodes.right(node);
+        }
+        return best;
+    }
+
+
+    // calls visit(element) for every element in [lo, hi], in order
+    template <typename F>
+    void range(const T &lo, const T &hi, F visit) const
+    {
+        range(root, lo, hi, visit);
+    }
+
+    vector<T> range(const T &lo, const T &hi) const
+    {
+        vector<T> found;
+        range(lo, hi, [&](const T &value)
+              { found.push_back(value); });
+        return found;
+    }
+
+    // out[i] = find(probes[i]), for probes in any order. Sorted probes go down the
+    // tree as they are; others are sorted once through an index permutation first.
+    void findBatch(const T *probes, size_t count, const T **out) const
+    {
+        if (is_sorted(probes, probes + count))
+        {
+            findBatch(root, probes, 0, count, out);
+            return;
+        }
+        vector<size_t> order(count);
+        for (size_t i = 0; i < count; i++)
+            order[i] = i;
+        sort(order.begin(), order.end(), [probes](size_t a, size_t b)
+             { return probes[a] < probes[b]; });
+        vector<T> sorted;
+        sorted.reserve(count);
+        for (size_t i : order)
+            sorted.push_back(probes[i]);
+        vector<const T *> found(count);
+        findBatch(root, sorted.data(), 0, count, found.data());
+        for (size_t i = 0; i < count; i++)
+            out[order[i]] = found[i];
+    }
+
+    // found[i] = contains(probes[i]), for probes in any order
+    void containsBatch(const T *probes, size_t count, bool *found) const
+    {
+        vector<const T *> out(count);
+        findBatch(probes, count, out.data());
+        for (size_t i = 0; i < count; i++)
+            found[i] = out[i] != nullptr;
+    }
+
+    // removes one occurrence of value; false if there was none
+    bool remove(const T &value)
+    {
+        bool removed = false;
+        root = remove(root, value, removed);
+        return removed;
+    }
+
+    // visits every element in order; iterative, so deep trees cannot overflow the stack
+    template <typename F>
+    void inorder(F visit) const
+    {
+        for (const T &value : inorder())
+            visit(value);
+    }
+
+    template <typename F>
+    void preorder(F visit) const
+    {
+        for (const T &value : preorder())
+            visit(value);
+    }
+
+    template <typename F>
+    void postorder(F visit) const
+    {
+        for (const T &value : postorder())
+            visit(value);
+    }
+
+    template <typename F>
+    void levelOrder(F visit) const
+    {
+        for (const T &value : levelOrder())
+            visit(value);
+    }
+
+    // Morris traversal: inorder with O(1) extra memory. The empty right link of each
+    // node's predecessor is pointed back at the node on the way down and reset on the
+    // way back up, so the tree is only whole again once the walk finishes and must not
+    // be read by anyone else meanwhile. If visit throws, the walk still runs to the end
+    // (without visiting) to undo the threads, then rethrows.
+    template <typename F>
+    void morrisInorder(F visit)
+    {
+        exception_ptr failure;
+        auto emit = [&](Link node)
+        {
+            if (failure)
+                return;
+            try
+            {
+                visit((const T &)nodes.data(node));
+            }
+            catch (...)
+            {
+                failure = current_exception();
+            }
+        };
+
+        Link node = root;
+        while (node != Storage::none)
+        {
+            if (nodes.left(node) == Storage::none)
+            {
+                emit(node);
+                node = nodes.right(node);
+                continue;
+            }
+            Link predecessor = nodes.left(node);
+            while (nodes.right(predecessor) != Storage::none && nodes.right(predecessor) != node)
+                predecessor = nodes.right(predecessor);
+            if (nodes.right(predecessor) == Storage::none)
+            {
+                nodes.right(predecessor) = node;
+                node = nodes.left(node);
+            }
+            else
+            {
+                nodes.right(predecessor) = Storage::none;
+                emit(node);
+                node = nodes.right(node);
+            }
+        }
+        if (failure)
+            rethrow_exception(failure);
+    }
+
     void printInorder()
     {
         cout << "Inorder: ";
-        inorder(root);
+        inorder([](const T &value)
+                { cout << value << " "; });
         cout << endl;
     }
 
     void printPreorder()
     {
         cout << "Preorder: ";
-        preorder(root);
+        preorder([](const T &value)
+                 { cout << value << " "; });
         cout << endl;
     }
 
     void printPostorder()
     {
         cout << "Postorder: ";
-        postorder(root);
+        postorder([](const T &value)
+                  { cout << value << " "; });
         cout << endl;
     }
 
     int height()
     {
+        if constexpr (balanced)
+            return level(root);
         return height(root);
     }
 
@@ -194,8 +854,11 @@ public:
 
     void clear()
     {
-        deleteTree(root);
-        root = nullptr;
+        // an arena drops trivially destructible nodes without visiting them
+        if (!Storage::releasesAll || !is_trivially_destructible<T>::value)
+            deleteTree(root);
+        nodes.releaseAll();
+        root = Storage::none;
     }
 
     ~BinaryTree()
@@ -211,12 +874,13 @@ public:
     void printLevelOrder()
     {
         cout << "Level Order: ";
-        levelOrder(root);
+        levelOrder([](const T &value)
+                   { cout << value << " "; });
         cout << endl;
     }
 
-    bool isEqual(BinaryTree<T> &other)
+    bool isEqual(BinaryTree &other)
     {
-        return identical(root, other.root);
+        return identical(root, other, other.root);
     }
 };
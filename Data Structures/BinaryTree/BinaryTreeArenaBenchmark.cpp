@@ -0,0 +1,68 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include "BinaryTree.cpp"
+using namespace std;
+
+double seconds(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// build, look up, remove and re-insert a quarter of the keys (which the arena serves
+// from its free list), then tear the tree down
+template <typename Tree>
+void run(const char *label, const vector<int> &keys, const vector<int> &probes)
+{
+    size_t n = keys.size();
+    Tree t;
+
+    auto start = chrono::steady_clock::now();
+    for (int k : keys)
+        t.insert(k);
+    double build = seconds(start);
+
+    long long hits = 0;
+    start = chrono::steady_clock::now();
+    for (int p : probes)
+        hits += t.contains(p);
+    double lookup = seconds(start);
+
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < n / 4; i++)
+        t.remove(keys[i]);
+    for (size_t i = 0; i < n / 4; i++)
+        t.insert(keys[i]);
+    double churn = seconds(start);
+
+    hits += t.countNodes() == (int)n ? 0 : -1000000000;
+    start = chrono::steady_clock::now();
+    t.clear();
+    double teardown = seconds(start);
+
+    cout << label << ": build " << build * 1e3 << " ms, lookup " << probes.size() / lookup / 1e6
+         << " M/s, remove+insert " << n / 2 / churn / 1e6 << " M ops/s, clear " << teardown * 1e3
+         << " ms  (" << hits << " hits)" << endl;
+}
+
+int main(int argc, char **argv)
+{
+    int n = argc > 1 ? atoi(argv[1]) : 1000000;
+    int probeCount = argc > 2 ? atoi(argv[2]) : 1000000;
+
+    mt19937 rng(11);
+    vector<int> keys(n), probes(probeCount);
+    for (int &k : keys)
+        k = (int)(rng() % (4u * n));
+    for (int &p : probes)
+        p = (int)(rng() % (4u * n));
+
+    cout << n << " random keys, " << probeCount << " probes" << endl;
+    run<BinaryTree<int, true>>("AVL, new/delete   ", keys, probes);
+    run<BinaryTree<int, true, NodeArena<int, true>>>("AVL, arena        ", keys, probes);
+    run<BinaryTree<int>>("plain, new/delete ", keys, probes);
+    run<BinaryTree<int, false, NodeArena<int>>>("plain, arena      ", keys, probes);
+    return 0;
+}
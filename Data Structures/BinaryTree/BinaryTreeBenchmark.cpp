@@ -0,0 +1,99 @@
+#include <iostream>
+#include <vector>
+#include <set>
+#include <string>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include "BinaryTree.cpp"
+using namespace std;
+
+double seconds(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+vector<int> keys(const string &order, int n)
+{
+    vector<int> k(n);
+    for (int i = 0; i < n; i++)
+        k[i] = i;
+    if (order == "reverse")
+        reverse(k.begin(), k.end());
+    else if (order == "random")
+        shuffle(k.begin(), k.end(), mt19937(1));
+    return k;
+}
+
+template <typename Tree>
+void run(const char *label, const vector<int> &k)
+{
+    Tree *t = new Tree();
+    auto start = chrono::steady_clock::now();
+    for (int x : k)
+        t->insert(x);
+    double build = seconds(start);
+    int height = t->height();
+
+    // remove every other key, then tear down
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < k.size(); i += 2)
+        t->remove(k[i]);
+    double removal = seconds(start);
+    int left = t->countNodes();
+    start = chrono::steady_clock::now();
+    delete t;
+    double teardown = seconds(start);
+
+    cout << "    " << label << ": insert " << k.size() / build / 1e6 << " M/s, height " << height
+         << ", remove half " << k.size() / 2 / removal / 1e6 << " M/s (" << left << " left), teardown "
+         << teardown * 1e3 << " ms" << endl;
+}
+
+// the same steps for std::set, which has no height to report
+void runSet(const vector<int> &k)
+{
+    set<int> *s = new set<int>();
+    auto start = chrono::steady_clock::now();
+    for (int x : k)
+        s->insert(x);
+    double build = seconds(start);
+
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < k.size(); i += 2)
+        s->erase(k[i]);
+    double removal = seconds(start);
+    size_t left = s->size();
+    start = chrono::steady_clock::now();
+    delete s;
+    double teardown = seconds(start);
+
+    cout << "    std::set        : insert " << k.size() / build / 1e6 << " M/s, remove half "
+         << k.size() / 2 / removal / 1e6 << " M/s (" << left << " left), teardown " << teardown * 1e3 << " ms" << endl;
+}
+
+int main(int argc, char **argv)
+{
+    // up to 10^8 keys (about 4 GB with std::set alongside) when passed explicitly
+    long long maxKeys = argc > 1 ? atoll(argv[1]) : 1000000;
+    // sorted keys turn the plain tree into a list: O(n^2) inserts and recursion as deep as n
+    int maxDegenerate = argc > 2 ? atoi(argv[2]) : 20000;
+
+    for (long long n = 10000; n <= maxKeys; n *= 10)
+    {
+        for (string order : {"sorted", "reverse", "random"})
+        {
+            vector<int> k = keys(order, (int)n);
+            cout << n << " " << order << " keys" << endl;
+            run<BinaryTree<int, true>>("AVL BinaryTree ", k);
+            if (order == "random" || n <= maxDegenerate)
+                run<BinaryTree<int>>("plain BinaryTree", k);
+            else
+                cout << "    plain BinaryTree: skipped, it degenerates into a list" << endl;
+
+            runSet(k);
+        }
+    }
+    return 0;
+}
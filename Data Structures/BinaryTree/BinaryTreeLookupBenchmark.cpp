@@ -0,0 +1,134 @@
+#include <iostream>
+#include <vector>
+#include <set>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include "BinaryTree.cpp"
+using namespace std;
+
+double seconds(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+template <typename Tree>
+void run(const char *label, const vector<int> &keys, const vector<int> &probes, const vector<int> &sortedProbes)
+{
+    Tree t;
+    for (int k : keys)
+        t.insert(k);
+    size_t n = probes.size();
+
+    long long hits = 0;
+    auto start = chrono::steady_clock::now();
+    for (int p : probes)
+        hits += t.contains(p);
+    double contains = seconds(start);
+
+    long long sum = 0;
+    start = chrono::steady_clock::now();
+    for (int p : probes)
+    {
+        const int *l = t.lower_bound(p);
+        sum += l != nullptr ? *l : 0;
+    }
+    double lower = seconds(start);
+
+    // short scans: about 10 elements each
+    long long scanned = 0;
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < n / 10; i++)
+        t.range(probes[i], probes[i] + 20, [&](const int &)
+                { scanned++; });
+    double range = seconds(start);
+
+    vector<const int *> out(n);
+    start = chrono::steady_clock::now();
+    t.findBatch(sortedProbes.data(), n, out.data());
+    double batch = seconds(start);
+    long long batchHits = 0;
+    for (const int *p : out)
+        batchHits += p != nullptr;
+
+    start = chrono::steady_clock::now();
+    long long sortedHits = 0;
+    for (int p : sortedProbes)
+        sortedHits += t.contains(p);
+    double sortedOneByOne = seconds(start);
+
+    cout << label << ": contains " << n / contains / 1e6 << " M/s, lower_bound " << n / lower / 1e6
+         << " M/s, range " << n / 10 / range / 1e6 << " M scans/s, sorted probes one by one "
+         << n / sortedOneByOne / 1e6 << " M/s, batched " << n / batch / 1e6 << " M/s"
+         << (batchHits == hits && sortedHits == hits ? "" : "  MISMATCH")
+         << "  (" << hits << " hits, " << scanned << " scanned, " << sum % 1000 << ")" << endl;
+}
+
+void runSet(const vector<int> &keys, const vector<int> &probes, const vector<int> &sortedProbes)
+{
+    set<int> s(keys.begin(), keys.end());
+    size_t n = probes.size();
+
+    long long hits = 0;
+    auto start = chrono::steady_clock::now();
+    for (int p : probes)
+        hits += s.count(p);
+    double contains = seconds(start);
+
+    long long sum = 0;
+    start = chrono::steady_clock::now();
+    for (int p : probes)
+    {
+        auto it = s.lower_bound(p);
+        sum += it != s.end() ? *it : 0;
+    }
+    double lower = seconds(start);
+
+    long long scanned = 0;
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < n / 10; i++)
+    {
+        for (auto it = s.lower_bound(probes[i]), end = s.upper_bound(probes[i] + 20); it != end; ++it)
+            scanned++;
+    }
+    double range = seconds(start);
+
+    // std::set has no batched lookup; the same sorted probes one at a time instead
+    start = chrono::steady_clock::now();
+    long long sortedHits = 0;
+    for (int p : sortedProbes)
+        sortedHits += s.count(p);
+    double sortedOneByOne = seconds(start);
+
+    cout << "std::set        : contains " << n / contains / 1e6 << " M/s, lower_bound " << n / lower / 1e6
+         << " M/s, range " << n / 10 / range / 1e6 << " M scans/s, sorted probes one by one "
+         << n / sortedOneByOne / 1e6 << " M/s" << (sortedHits == hits ? "" : "  MISMATCH") << "  (" << hits << " hits, " << scanned << " scanned, "
+         << sum % 1000 << ")" << endl;
+}
+
+int main(int argc, char **argv)
+{
+    int maxKeys = argc > 1 ? atoi(argv[1]) : 1000000;
+    int probeCount = argc > 2 ? atoi(argv[2]) : 1000000;
+
+    for (int n = 1000; n <= maxKeys; n *= 10)
+    {
+        mt19937 rng(5);
+        vector<int> keys(n), probes(probeCount);
+        // every other even number is a key, so about half the probes hit
+        for (int i = 0; i < n; i++)
+            keys[i] = 2 * i;
+        shuffle(keys.begin(), keys.end(), rng);
+        for (int &p : probes)
+            p = (int)(rng() % (4u * n));
+        vector<int> sortedProbes = probes;
+        sort(sortedProbes.begin(), sortedProbes.end());
+
+        cout << n << " keys, " << probeCount << " probes" << endl;
+        run<BinaryTree<int>>("plain BinaryTree", keys, probes, sortedProbes);
+        run<BinaryTree<int, true>>("AVL BinaryTree  ", keys, probes, sortedProbes);
+        runSet(keys, probes, sortedProbes);
+    }
+    return 0;
+}
@@ -0,0 +1,185 @@
+#include <iostream>
+#include <streambuf>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include "BinaryTree.cpp"
+using namespace std;
+
+double seconds(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// swallows everything written to it; numbers are still formatted on the way in
+class NullBuffer : public streambuf
+{
+protected:
+    int overflow(int c) override
+    {
+        return c;
+    }
+
+    streamsize xsputn(const char *, streamsize n) override
+    {
+        return n;
+    }
+};
+
+// The printers as they were before the iterators: recursive, straight to cout. They
+// run on a copy of the tree built from Node<T> with the same insertion order.
+namespace recursive
+{
+    Node<int> *insert(Node<int> *root, int value)
+    {
+        Node<int> **link = &root;
+        while (*link != nullptr)
+            link = value < (*link)->data ? &(*link)->left : &(*link)->right;
+        *link = new Node<int>(value);
+        return root;
+    }
+
+    void inorder(Node<int> *node)
+    {
+        if (node != nullptr)
+        {
+            inorder(node->left);
+            cout << node->data << " ";
+            inorder(node->right);
+        }
+    }
+
+    void preorder(Node<int> *node)
+    {
+        if (node != nullptr)
+        {
+            cout << node->data << " ";
+            preorder(node->left);
+            preorder(node->right);
+        }
+    }
+
+    void postorder(Node<int> *node)
+    {
+        if (node != nullptr)
+        {
+            postorder(node->left);
+            postorder(node->right);
+            cout << node->data << " ";
+        }
+    }
+
+    void sum(Node<int> *node, long long &total)
+    {
+        if (node != nullptr)
+        {
+            sum(node->left, total);
+            total += node->data;
+            sum(node->right, total);
+        }
+    }
+
+    void destroy(Node<int> *node)
+    {
+        if (node != nullptr)
+        {
+            destroy(node->left);
+            destroy(node->right);
+            delete node;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int n = argc > 1 ? atoi(argv[1]) : 1000000;
+    int repeats = argc > 2 ? atoi(argv[2]) : 5;
+
+    mt19937 rng(7);
+    BinaryTree<int> t;
+    Node<int> *copy = nullptr;
+    for (int i = 0; i < n; i++)
+    {
+        int key = (int)(rng() % (10u * n));
+        t.insert(key);
+        copy = recursive::insert(copy, key);
+    }
+    double total = (double)n * repeats;
+    cout << n << " random keys, " << repeats << " passes" << endl;
+
+    // printing, with cout pointed at a buffer that drops everything
+    NullBuffer discard;
+    streambuf *console = cout.rdbuf(&discard);
+    double times[6];
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+        recursive::inorder(copy);
+    times[0] = seconds(start);
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+        t.printInorder();
+    times[1] = seconds(start);
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+        recursive::preorder(copy);
+    times[2] = seconds(start);
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+        t.printPreorder();
+    times[3] = seconds(start);
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+        recursive::postorder(copy);
+    times[4] = seconds(start);
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+        t.printPostorder();
+    times[5] = seconds(start);
+    cout.rdbuf(console);
+    cout << "print inorder   : recursive " << total / times[0] / 1e6 << " M/s, iterator " << total / times[1] / 1e6 << " M/s" << endl;
+    cout << "print preorder  : recursive " << total / times[2] / 1e6 << " M/s, iterator " << total / times[3] / 1e6 << " M/s" << endl;
+    cout << "print postorder : recursive " << total / times[4] / 1e6 << " M/s, iterator " << total / times[5] / 1e6 << " M/s" << endl;
+
+    // walking without output: summing the elements
+    long long sums[7] = {0, 0, 0, 0, 0, 0, 0};
+    const char *labels[7] = {"recursive inorder", "inorder iterator", "inorder visitor", "Morris inorder",
+                             "preorder iterator", "postorder iterator", "level order iterator"};
+    double walk[7];
+    for (int k = 0; k < 7; k++)
+    {
+        start = chrono::steady_clock::now();
+        for (int r = 0; r < repeats; r++)
+        {
+            switch (k)
+            {
+            case 0: recursive::sum(copy, sums[k]); break;
+            case 1:
+                for (int value : t)
+                    sums[k] += value;
+                break;
+            case 2: t.inorder([&](int value) { sums[2] += value; }); break;
+            case 3: t.morrisInorder([&](int value) { sums[3] += value; }); break;
+            case 4:
+                for (int value : t.preorder())
+                    sums[k] += value;
+                break;
+            case 5:
+                for (int value : t.postorder())
+                    sums[k] += value;
+                break;
+            default:
+                for (int value : t.levelOrder())
+                    sums[k] += value;
+                break;
+            }
+        }
+        walk[k] = seconds(start);
+    }
+    for (int k = 0; k < 7; k++)
+        cout << "sum, " << labels[k] << ": " << total / walk[k] / 1e6 << " M/s"
+             << (sums[k] == sums[0] ? "" : "  MISMATCH") << endl;
+
+    recursive::destroy(copy);
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "BinaryTree.cpp"
+using namespace std;
+
+// Key and both children in one struct: 12 bytes for an int key, against 24 for
+// Node<int> (and 32 once malloc has added its header).
+template <typename T>
+struct CompactNode
+{
+    T data;
+    uint32_t left;
+    uint32_t right;
+};
+
+// Node storage policy for BinaryTree that keeps every node in one vector and links
+// children by 32-bit index instead of by pointer. With levelled = true the AVL heights
+// live in a separate byte per node so that they do not pad out CompactNode. Destroyed
+// slots are chained through `left` into a free list and reused by the next create().
+// Creating can move the vector, so element pointers from find(), lower_bound() and the
+// iterators only stay valid until the tree is next modified. Holds at most 2^32 - 1
+// nodes.
+template <typename T, bool levelled = false>
+class IndexNodes
+{
+private:
+    vector<CompactNode<T>> nodes;
+    vector<signed char> levels; // levelled only
+    uint32_t freeList;
+
+public:
+    typedef uint32_t Link;
+    static constexpr Link none = 0xFFFFFFFF;
+    static const bool releasesAll = true;
+    static const bool keepsLevels = levelled;
+
+    IndexNodes() : freeList(none) {}
+
+    T &data(Link node) { return nodes[node].data; }
+    const T &data(Link node) const { return nodes[node].data; }
+    Link &left(Link node) { return nodes[node].left; }
+    Link left(Link node) const { return nodes[node].left; }
+    Link &right(Link node) { return nodes[node].right; }
+    Link right(Link node) const { return nodes[node].right; }
+    signed char &level(Link node) { return levels[node]; }
+    signed char level(Link node) const { return levels[node]; }
+
+    Link create(const T &value)
+    {
+        Link node = freeList;
+        if (node != none)
+        {
+            freeList = nodes[node].left;
+            nodes[node] = CompactNode<T>{value, none, none};
+        }
+        else
+        {
+            if (nodes.size() >= none)
+                throw length_error("IndexNodes is full");
+            node = (Link)nodes.size();
+            nodes.push_back(CompactNode<T>{value, none, none});
+            if (levelled)
+                levels.push_back(0);
+        }
+        if (levelled)
+            levels[node] = 0;
+        return node;
+    }
+
+    void destroy(Link node)
+    {
+        nodes[node].data = T();
+        nodes[node].left = freeList;
+        freeList = node;
+    }
+
+    // drops every node at once; the vector keeps its capacity for the next build
+    void releaseAll()
+    {
+        nodes.clear();
+        levels.clear();
+        freeList = none;
+    }
+
+    // makes room for n nodes in total, so that building the tree does not reallocate
+    void reserve(size_t n)
+    {
+        nodes.reserve(n);
+        if (levelled)
+            levels.reserve(n);
+    }
+
+    // bytes held by the node storage, including spare capacity and free slots
+    size_t bytes() const
+    {
+        return nodes.capacity() * sizeof(CompactNode<T>) + levels.capacity() * sizeof(signed char);
+    }
+};
+
+// BinaryTree with every node in one vector, linked by 32-bit index: same operations and
+// the same balanced = true AVL mode, at 12 bytes a node for int keys.
+template <typename T, bool balanced = false>
+using CompactBinaryTree = BinaryTree<T, balanced, IndexNodes<T, balanced>>;
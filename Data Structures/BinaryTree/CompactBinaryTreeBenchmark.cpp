@@ -0,0 +1,75 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <malloc.h>
+#include "CompactBinaryTree.cpp"
+using namespace std;
+
+double seconds(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// bytes the allocator has handed out, malloc headers and slab slack included
+size_t heapInUse()
+{
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+// bytes per key as seen by malloc, lookups per second, and latency of a chain of
+// lookups where each probe depends on the previous answer
+template <typename Tree>
+void run(const char *label, const vector<int> &keys, const vector<int> &probes)
+{
+    size_t before = heapInUse();
+    Tree *t = new Tree();
+    auto start = chrono::steady_clock::now();
+    for (int k : keys)
+        t->insert(k);
+    double build = seconds(start);
+    double perKey = (double)(heapInUse() - before) / keys.size();
+
+    long long hits = 0;
+    start = chrono::steady_clock::now();
+    for (int p : probes)
+        hits += t->contains(p);
+    double lookup = seconds(start);
+
+    long long chained = 0;
+    start = chrono::steady_clock::now();
+    for (int p : probes)
+        chained += t->contains(p + (int)(chained & 1));
+    double latency = seconds(start);
+
+    cout << label << ": " << perKey << " bytes/key, build " << build * 1e3 << " ms, "
+         << probes.size() / lookup / 1e6 << " M lookups/s, " << latency / probes.size() * 1e9
+         << " ns/dependent lookup  (" << hits << " hits, " << chained << " chained)" << endl;
+    delete t;
+}
+
+int main(int argc, char **argv)
+{
+    int n = argc > 1 ? atoi(argv[1]) : 1000000;
+    int probeCount = argc > 2 ? atoi(argv[2]) : 1000000;
+
+    mt19937 rng(13);
+    vector<int> keys(n), probes(probeCount);
+    for (int &k : keys)
+        k = (int)(rng() % (4u * n));
+    for (int &p : probes)
+        p = (int)(rng() % (4u * n));
+
+    cout << n << " random keys, " << probeCount << " probes; sizeof Node<int> " << sizeof(Node<int>)
+         << " (AVL " << sizeof(Node<int, true>) << "), Node<long long> " << sizeof(Node<long long>)
+         << " (AVL " << sizeof(Node<long long, true>) << "), CompactNode<int> " << sizeof(CompactNode<int>) << endl;
+    run<BinaryTree<int>>("pointer nodes, new/delete  ", keys, probes);
+    run<BinaryTree<int, false, NodeArena<int>>>("pointer nodes, arena      ", keys, probes);
+    run<CompactBinaryTree<int>>("32-bit index nodes        ", keys, probes);
+    run<BinaryTree<int, true>>("AVL pointer, new/delete   ", keys, probes);
+    run<BinaryTree<int, true, NodeArena<int, true>>>("AVL pointer, arena        ", keys, probes);
+    run<CompactBinaryTree<int, true>>("AVL 32-bit index          ", keys, probes);
+    return 0;
+}
@@ -52,22 +52,19 @@ public:
         cout << endl;
     }
 
-    void remove(T value)
+    // returns false instead of throwing when the list is empty or value is missing
+    bool try_remove(T value)
     {
         if (!tail)
-        {
-            throw runtime_error("Cannot remove from empty list.");
-        }
+            return false;
 
         Node<T> *current = tail->next;
         Node<T> *prev = tail;
-        bool found = false;
 
         do
         {
             if (current->data == value)
             {
-                found = true;
                 if (current == tail && current == tail->next)
                 {
                     delete current;
@@ -80,13 +77,23 @@ public:
                         tail = prev;
                     delete current;
                 }
-                break;
+                return true;
             }
             prev = current;
             current = current->next;
         } while (current != tail->next);
 
-        if (!found)
+        return false;
+    }
+
+    void remove(T value)
+    {
+        if (!tail)
+        {
+            throw runtime_error("Cannot remove from empty list.");
+        }
+
+        if (!try_remove(value))
         {
             throw invalid_argument("Value not found in list.");
         }
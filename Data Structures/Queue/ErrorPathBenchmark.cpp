@@ -0,0 +1,151 @@
+#include <iostream>
+#include <chrono>
+#include <stdexcept>
+#include "Queue.h"
+#include "../Stack/Stack.h"
+#include "../Linked List/Circular_Linked_List.cpp"
+using namespace std;
+
+// Workload dominated by empty/full conditions: every other call fails.
+const int operations = 2000000;
+// read at runtime so the compiler cannot fold the whole loop away
+volatile int smallCapacity = 1;
+
+double seconds(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// both loops make the same calls, so they must fail the same number of times
+void report(const char *name, double throwing, double nonThrowing, int failures, int tryFailures)
+{
+    cout << name << ": exceptions " << throwing / operations * 1e9 << " ns/op, try_ "
+         << nonThrowing / operations * 1e9 << " ns/op (" << failures << " failed calls each)";
+    if (failures != tryFailures)
+        cout << "  MISMATCH: " << tryFailures << " failed try_ calls";
+    cout << '\n';
+}
+
+void queueBench()
+{
+    Queue<int> q(smallCapacity);
+    int failures = 0, tryFailures = 0;
+
+    // even i: add, remove; odd i: remove, remove. Each call stands alone, so both loops
+    // make the same calls and fail on the same ones.
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < operations; i++)
+    {
+        try
+        {
+            if (i % 2 == 0)
+                q.add(i);
+            else
+                q.remove();
+        }
+        catch (const QueueException &)
+        {
+            failures++;
+        }
+        try
+        {
+            q.remove();
+        }
+        catch (const QueueException &)
+        {
+            failures++;
+        }
+    }
+    double throwing = seconds(start);
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < operations; i++)
+    {
+        if (i % 2 == 0 ? !q.try_push(i) : !q.try_remove())
+            tryFailures++;
+        if (!q.try_remove())
+            tryFailures++;
+    }
+    double nonThrowing = seconds(start);
+    report("Queue", throwing, nonThrowing, failures, tryFailures);
+}
+
+void stackBench()
+{
+    Stack<int> s(smallCapacity);
+    int failures = 0, tryFailures = 0, value;
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < operations; i++)
+    {
+        try
+        {
+            s.push(i);
+            s.push(i);
+        }
+        catch (const StackException &)
+        {
+            failures++;
+        }
+        try
+        {
+            s.pop();
+            s.top();
+        }
+        catch (const StackException &)
+        {
+            failures++;
+        }
+    }
+    double throwing = seconds(start);
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < operations; i++)
+    {
+        if (!s.try_push(i) || !s.try_push(i))
+            tryFailures++;
+        if (!s.try_pop() || !s.try_top(value))
+            tryFailures++;
+    }
+    double nonThrowing = seconds(start);
+    report("Stack", throwing, nonThrowing, failures, tryFailures);
+}
+
+void listBench()
+{
+    CircularLinkedList<int> list;
+    for (int i = 0; i < 8; i++)
+        list.append(i);
+    int failures = 0, tryFailures = 0;
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < operations; i++)
+    {
+        try
+        {
+            list.remove(-1);
+        }
+        catch (const invalid_argument &)
+        {
+            failures++;
+        }
+    }
+    double throwing = seconds(start);
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < operations; i++)
+    {
+        if (!list.try_remove(-1))
+            tryFailures++;
+    }
+    double nonThrowing = seconds(start);
+    report("CircularLinkedList", throwing, nonThrowing, failures, tryFailures);
+}
+
+int main()
+{
+    queueBench();
+    stackBench();
+    listBench();
+    return 0;
+}
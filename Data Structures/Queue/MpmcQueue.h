@@ -0,0 +1,262 @@
+#ifndef MPMCQUEUE_H
+#define MPMCQUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "QueueException.h"
+
+// Bounded circular queue for any number of producer and consumer threads.
+// Every slot carries a sequence number that tells whose turn it is: a producer at
+// position pos may fill the slot when sequence == pos, a consumer may empty it when
+// sequence == pos + 1. Producers and consumers only meet on the slot they both want.
+// The mutex is used only to park threads in the blocking calls, never on the fast path.
+template <typename T>
+class MpmcQueue
+{
+private:
+    static const size_t cacheLine = 64;
+    static const int spinCount = 64;
+
+    struct Cell
+    {
+        atomic<size_t> sequence;
+        T data;
+    };
+
+    Cell *a;
+    size_t capacity;
+
+    alignas(cacheLine) atomic<size_t> enqueuePos;
+    alignas(cacheLine) atomic<size_t> dequeuePos;
+
+    alignas(cacheLine) mutex m;
+    condition_variable notFull;
+    condition_variable notEmpty;
+    atomic<int> waitingProducers;
+    atomic<int> waitingConsumers;
+
+    void wake(atomic<int> &waiting, condition_variable &cv)
+    {
+        // pairs with the fence in park(): either the sleeper sees our slot or we see the sleeper
+        atomic_thread_fence(memory_order_seq_cst);
+        if (waiting.load(memory_order_relaxed) > 0)
+        {
+            lock_guard<mutex> lock(m);
+            cv.notify_one();
+        }
+    }
+
+    // Spins, then sleeps on cv until attempt() succeeds or the deadline passes. attempt
+    // must not wake anyone: it runs under m, and wake() takes m. The caller wakes the
+    // other side after park() has returned and let go of the lock.
+    template <typename Try, typename Clock, typename Duration>
+    bool park(Try attempt, atomic<int> &waiting, condition_variable &cv,
+              const chrono::time_point<Clock, Duration> *deadline)
+    {
+        for (int i = 0; i < spinCount; i++)
+        {
+            if (attempt())
+                return true;
+            this_thread::yield();
+        }
+
+        unique_lock<mutex> lock(m);
+        waiting.fetch_add(1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        bool done = attempt();
+        while (!done)
+        {
+            if (deadline == nullptr)
+            {
+                cv.wait(lock);
+            }
+            else if (cv.wait_until(lock, *deadline) == cv_status::timeout)
+            {
+                done = attempt();
+                break;
+            }
+            done = attempt();
+        }
+        waiting.fetch_sub(1, memory_order_relaxed);
+        return done;
+    }
+
+    // try_push without the wake-up
+    bool claimPush(const T &item)
+    {
+        size_t pos = enqueuePos.load(memory_order_relaxed);
+        while (true)
+        {
+            Cell &cell = a[pos % capacity];
+            size_t seq = cell.sequence.load(memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0)
+            {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                {
+                    cell.data = item;
+                    cell.sequence.store(pos + 1, memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                // the slot still holds the item from one lap ago
+                return false;
+            }
+            else
+            {
+                pos = enqueuePos.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    // try_pop without the wake-up
+    bool claimPop(T &item)
+    {
+        size_t pos = dequeuePos.load(memory_order_relaxed);
+        while (true)
+        {
+            Cell &cell = a[pos % capacity];
+            size_t seq = cell.sequence.load(memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+            if (diff == 0)
+            {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                {
+                    item = cell.data;
+                    cell.sequence.store(pos + capacity, memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = dequeuePos.load(memory_order_relaxed);
+            }
+        }
+    }
+
+public:
+    MpmcQueue(int c)
+    {
+        // with one cell, a producer cannot tell the slot's "full" sequence from the next
+        // lap's "empty" one
+        if (c < 2)
+        {
+            throw QueueException("Capacity must be at least 2");
+        }
+        capacity = c;
+        a = new Cell[capacity];
+        for (size_t i = 0; i < capacity; i++)
+        {
+            a[i].sequence.store(i, memory_order_relaxed);
+        }
+        enqueuePos.store(0, memory_order_relaxed);
+        dequeuePos.store(0, memory_order_relaxed);
+        waitingProducers.store(0, memory_order_relaxed);
+        waitingConsumers.store(0, memory_order_relaxed);
+    }
+
+    MpmcQueue(const MpmcQueue &) = delete;
+    MpmcQueue &operator=(const MpmcQueue &) = delete;
+
+    ~MpmcQueue()
+    {
+        delete[] a;
+    }
+
+    bool try_push(const T &item)
+    {
+        if (!claimPush(item))
+            return false;
+        wake(waitingConsumers, notEmpty);
+        return true;
+    }
+
+    bool try_pop(T &item)
+    {
+        if (!claimPop(item))
+            return false;
+        wake(waitingProducers, notFull);
+        return true;
+    }
+
+    void push(const T &item)
+    {
+        const chrono::steady_clock::time_point *forever = nullptr;
+        park([&]()
+             { return claimPush(item); },
+             waitingProducers, notFull, forever);
+        wake(waitingConsumers, notEmpty);
+    }
+
+    void pop(T &item)
+    {
+        const chrono::steady_clock::time_point *forever = nullptr;
+        park([&]()
+             { return claimPop(item); },
+             waitingConsumers, notEmpty, forever);
+        wake(waitingProducers, notFull);
+    }
+
+    template <typename Rep, typename Period>
+    bool push_for(const T &item, const chrono::duration<Rep, Period> &timeout)
+    {
+        auto deadline = chrono::steady_clock::now() + timeout;
+        if (!park([&]()
+                  { return claimPush(item); },
+                  waitingProducers, notFull, &deadline))
+            return false;
+        wake(waitingConsumers, notEmpty);
+        return true;
+    }
+
+    template <typename Rep, typename Period>
+    bool pop_for(T &item, const chrono::duration<Rep, Period> &timeout)
+    {
+        auto deadline = chrono::steady_clock::now() + timeout;
+        if (!park([&]()
+                  { return claimPop(item); },
+                  waitingConsumers, notEmpty, &deadline))
+            return false;
+        wake(waitingProducers, notFull);
+        return true;
+    }
+
+    void add(const T &item)
+    {
+        if (!try_push(item))
+        {
+            throw QueueException("Queue is full");
+        }
+    }
+
+    // approximate while other threads are running
+    int getSize() const
+    {
+        size_t head = dequeuePos.load(memory_order_acquire);
+        size_t tail = enqueuePos.load(memory_order_acquire);
+        return tail > head ? (int)(tail - head) : 0;
+    }
+
+    bool isEmpty() const
+    {
+        return getSize() == 0;
+    }
+
+    int getCapacity() const
+    {
+        return (int)capacity;
+    }
+};
+
+#endif
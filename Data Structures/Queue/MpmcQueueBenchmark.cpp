@@ -0,0 +1,108 @@
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include "MpmcQueue.h"
+using namespace std;
+
+int itemsPerProducer = 1000000;
+
+void run(int producers, int consumers, int capacity = 4096)
+{
+    MpmcQueue<long long> q(capacity);
+    long long total = (long long)itemsPerProducer * producers;
+    vector<long long> sums(consumers, 0);
+    vector<thread> threads;
+
+    auto start = chrono::steady_clock::now();
+    for (int p = 0; p < producers; p++)
+    {
+        threads.emplace_back([&]()
+                             {
+            for (int i = 0; i < itemsPerProducer; i++)
+                q.push(i); });
+    }
+    for (int c = 0; c < consumers; c++)
+    {
+        // each consumer takes an equal share; the last one takes the remainder
+        long long share = total / consumers + (c == consumers - 1 ? total % consumers : 0);
+        threads.emplace_back([&, c, share]()
+                             {
+            long long value;
+            for (long long i = 0; i < share; i++)
+            {
+                q.pop(value);
+                sums[c] += value;
+            } });
+    }
+    for (thread &t : threads)
+        t.join();
+    double t = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    long long sum = 0;
+    for (long long s : sums)
+        sum += s;
+    long long expected = (long long)itemsPerProducer * (itemsPerProducer - 1) / 2 * producers;
+
+    cout << producers << "P/" << consumers << "C";
+    if (capacity < 4096)
+        cout << ", capacity " << capacity;
+    cout << ": " << total / t / 1e6 << " M items/s"
+         << (sum == expected ? "" : "  CHECKSUM MISMATCH") << '\n';
+}
+
+int main(int argc, char *argv[])
+{
+    int maxThreads = thread::hardware_concurrency();
+    if (argc > 1)
+        maxThreads = atoi(argv[1]);
+    if (argc > 2)
+        itemsPerProducer = atoi(argv[2]);
+    if (maxThreads < 1)
+        maxThreads = 1;
+
+    for (int n = 1; n <= maxThreads; n *= 2)
+    {
+        run(n, n);
+        if (n > 1)
+        {
+            run(n, 1);
+            run(1, n);
+        }
+    }
+
+    // tiny queues keep both sides parking and waking each other
+    for (int capacity = 2; capacity <= 4; capacity++)
+        run(maxThreads, maxThreads, capacity);
+
+    bool ok = true;
+    try
+    {
+        MpmcQueue<int> tooSmall(1);
+        ok = false;
+    }
+    catch (const QueueException &)
+    {
+    }
+
+    // one element in, one element out, repeatedly, in the smallest queue there is
+    MpmcQueue<int> q(2);
+    int value;
+    for (int i = 0; i < 2000; i++)
+    {
+        q.push(i);
+        ok = ok && q.getSize() == 1;
+        q.pop(value);
+        ok = ok && value == i && q.isEmpty();
+    }
+    ok = ok && q.try_push(1) && q.try_push(2) && !q.try_push(3) && q.getSize() == 2;
+    ok = ok && q.try_pop(value) && value == 1 && q.try_pop(value) && value == 2 && !q.try_pop(value);
+    cout << "single element push/pop: " << (ok ? "ok" : "FAILED") << '\n';
+
+    auto start = chrono::steady_clock::now();
+    bool got = q.pop_for(value, chrono::milliseconds(50));
+    double waited = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "pop_for on empty queue: " << (got ? "got item" : "timed out") << " after " << waited * 1000 << " ms\n";
+    return ok && !got ? 0 : 1;
+}
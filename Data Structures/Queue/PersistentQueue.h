@@ -0,0 +1,328 @@
+#ifndef PERSISTENTQUEUE_H
+#define PERSISTENTQUEUE_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include "QueueException.h"
+
+// Circular queue kept in a memory-mapped file so its contents survive a restart.
+// The file is a small header holding front and rear followed by a fixed ring of
+// records. front and rear are free-running counters; a record stores the counter
+// it was written at plus a checksum, so after a crash the queue can tell valid
+// records from torn or stale ones. Elements are stored as raw bytes, which is why
+// T has to be trivially copyable.
+//
+// Writes go to the page cache immediately (a killed process loses nothing);
+// syncEvery controls how many adds are batched before msync makes them durable
+// against a machine crash. 0 means only sync() and the destructor flush.
+template <typename T>
+class PersistentQueue
+{
+private:
+    static_assert(is_trivially_copyable<T>::value, "PersistentQueue stores T as raw bytes");
+
+    static const uint64_t magic = 0x4c4f4f5053514550ULL; // "PEQSPOOL"
+
+    struct Header
+    {
+        uint64_t magic;
+        uint64_t recordSize;
+        uint64_t capacity;
+        uint64_t front;
+        uint64_t rear;
+    };
+
+    struct Record
+    {
+        uint64_t sequence;
+        uint32_t checksum;
+        T value;
+    };
+
+    int fd;
+    size_t mappedSize;
+    Header *header;
+    Record *records;
+    uint64_t capacity;
+    uint64_t front;
+    uint64_t rear;
+    int syncEvery;
+    int unsynced;
+
+    static uint32_t checksum(uint64_t sequence, const T &value)
+    {
+        // FNV-1a over the sequence number and the element bytes
+        uint32_t h = 2166136261u;
+        const unsigned char *p = reinterpret_cast<const unsigned char *>(&sequence);
+        for (size_t i = 0; i < sizeof(sequence); i++)
+            h = (h ^ p[i]) * 16777619u;
+        p = reinterpret_cast<const unsigned char *>(&value);
+        for (size_t i = 0; i < sizeof(T); i++)
+            h = (h ^ p[i]) * 16777619u;
+        return h;
+    }
+
+    bool valid(uint64_t sequence) const
+    {
+        const Record &r = records[sequence % capacity];
+        return r.sequence == sequence && r.checksum == checksum(sequence, r.value);
+    }
+
+    static string systemError(const string &what)
+    {
+        return what + ": " + strerror(errno);
+    }
+
+    void recover()
+    {
+        front = header->front;
+        rear = header->rear;
+        if (rear < front || rear - front > capacity)
+        {
+            throw QueueException("Spool header is corrupt");
+        }
+
+        // keep the longest valid prefix of what the header claims ...
+        uint64_t end = front;
+        while (end < rear && valid(end))
+            end++;
+        // ... and pick up records written after the header was last updated
+        if (end == rear)
+        {
+            while (end - front < capacity && valid(end))
+                end++;
+        }
+        rear = end;
+        header->rear = rear;
+    }
+
+    // whether the file behind fd starts with the header this queue would write
+    bool ownHeader(int file) const
+    {
+        Header h;
+        if (pread(file, &h, sizeof(h), 0) != (ssize_t)sizeof(h))
+            return false;
+        return h.magic == magic && h.recordSize == sizeof(Record) && h.capacity == capacity;
+    }
+
+    static size_t ringOffset()
+    {
+        return (sizeof(Header) + alignof(Record) - 1) / alignof(Record) * alignof(Record);
+    }
+
+    void release()
+    {
+        if (header != nullptr)
+        {
+            msync(header, mappedSize, MS_SYNC);
+            munmap(header, mappedSize);
+            header = nullptr;
+        }
+        if (fd >= 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+public:
+    PersistentQueue(const string &path, int c, int syncBatch = 1024)
+    {
+        if (c < 1)
+        {
+            throw QueueException("Capacity must be positive");
+        }
+        capacity = c;
+        syncEvery = syncBatch;
+        unsynced = 0;
+        header = nullptr;
+        mappedSize = sizeof(Header) + capacity * sizeof(Record);
+        // keep the ring aligned for Record
+        mappedSize += alignof(Record);
+
+        fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0)
+        {
+            throw QueueException(systemError("Cannot open " + path));
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+        {
+            int err = errno;
+            close(fd);
+            errno = err;
+            throw QueueException(systemError("Cannot stat " + path));
+        }
+        bool fresh = st.st_size == 0;
+        // A file cut short (a partial copy, a crash while the file system was growing
+        // it) is padded back out with zeros once its header checks out; recover() then
+        // drops the records the cut went through.
+        bool truncated = !fresh && (size_t)st.st_size < mappedSize && ownHeader(fd);
+        if (!fresh && !truncated && (size_t)st.st_size != mappedSize)
+        {
+            close(fd);
+            throw QueueException("Spool file " + path + " was created with a different capacity or type");
+        }
+        if ((fresh || truncated) && ftruncate(fd, (off_t)mappedSize) != 0)
+        {
+            int err = errno;
+            close(fd);
+            errno = err;
+            throw QueueException(systemError("Cannot size " + path));
+        }
+
+        void *p = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED)
+        {
+            int err = errno;
+            close(fd);
+            errno = err;
+            throw QueueException(systemError("Cannot map " + path));
+        }
+        header = static_cast<Header *>(p);
+        records = reinterpret_cast<Record *>(static_cast<char *>(p) + ringOffset());
+
+        if (fresh)
+        {
+            header->recordSize = sizeof(Record);
+            header->capacity = capacity;
+            header->front = 0;
+            header->rear = 0;
+            header->magic = magic;
+            front = rear = 0;
+            sync();
+        }
+        else if (header->magic != magic || header->recordSize != sizeof(Record) || header->capacity != capacity)
+        {
+            release();
+            throw QueueException("Spool file " + path + " was created with a different capacity or type");
+        }
+        else
+        {
+            recover();
+        }
+    }
+
+    PersistentQueue(const PersistentQueue &) = delete;
+    PersistentQueue &operator=(const PersistentQueue &) = delete;
+
+    ~PersistentQueue()
+    {
+        release();
+    }
+
+    // where ring slot i starts in the spool file, and how long a slot is; for tools
+    // that inspect or repair spools
+    static size_t slotOffset(int i)
+    {
+        return ringOffset() + (size_t)i * sizeof(Record);
+    }
+
+    static size_t slotSize()
+    {
+        return sizeof(Record);
+    }
+
+    bool isFull() const
+    {
+        return rear - front == capacity;
+    }
+
+    bool isEmpty() const
+    {
+        return rear == front;
+    }
+
+    // false when full. With syncEvery > 0 the periodic flush runs inside try_push, so
+    // a failing msync still throws QueueException after the element has been added.
+    bool try_push(const T &item)
+    {
+        if (isFull())
+            return false;
+
+        Record &r = records[rear % capacity];
+        r.value = item;
+        // over the stored copy: assignment need not copy T's padding bytes
+        r.checksum = checksum(rear, r.value);
+        r.sequence = rear;
+        rear++;
+        header->rear = rear;
+        if (syncEvery > 0 && ++unsynced >= syncEvery)
+            sync();
+        return true;
+    }
+
+    bool try_pop(T &out)
+    {
+        if (isEmpty())
+            return false;
+
+        out = records[front % capacity].value;
+        front++;
+        header->front = front;
+        return true;
+    }
+
+    void add(const T &item)
+    {
+        if (!try_push(item))
+        {
+            throw QueueException("Queue is full");
+        }
+    }
+
+    void remove()
+    {
+        if (isEmpty())
+        {
+            throw QueueException("Queue is empty");
+        }
+        front++;
+        header->front = front;
+    }
+
+    T frontValue() const
+    {
+        if (isEmpty())
+        {
+            throw QueueException("Queue is empty");
+        }
+        return records[front % capacity].value;
+    }
+
+    // flushes everything written so far to disk
+    void sync()
+    {
+        if (msync(header, mappedSize, MS_SYNC) != 0)
+        {
+            throw QueueException(systemError("msync failed"));
+        }
+        unsynced = 0;
+    }
+
+    void clear()
+    {
+        front = rear;
+        header->front = front;
+    }
+
+    int getSize() const
+    {
+        return (int)(rear - front);
+    }
+
+    int getCapacity() const
+    {
+        return (int)capacity;
+    }
+};
+
+#endif
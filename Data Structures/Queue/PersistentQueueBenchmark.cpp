@@ -0,0 +1,173 @@
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "PersistentQueue.h"
+using namespace std;
+
+struct Message
+{
+    long long id;
+    char payload[56];
+};
+
+const int capacity = 1 << 20;
+const int appends = 4000000;
+
+void throughput(const string &path, int syncEvery)
+{
+    ::remove(path.c_str());
+    PersistentQueue<Message> q(path, capacity, syncEvery);
+    Message m = {};
+    Message out;
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < appends; i++)
+    {
+        m.id = i;
+        if (!q.try_push(m))
+        {
+            // keep the ring half full so appends never stall
+            for (int k = 0; k < capacity / 2; k++)
+                q.try_pop(out);
+            q.try_push(m);
+        }
+    }
+    q.sync();
+    double t = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "syncEvery " << syncEvery << ": " << appends * sizeof(Message) / t / 1e6 << " MB/s, "
+         << appends / t / 1e6 << " M appends/s\n";
+}
+
+// A child process appends in batches and is SIGKILLed part-way through one;
+// reopening the spool must yield a gap-free run of ids with nothing torn.
+bool crashRecovery(const string &path)
+{
+    ::remove(path.c_str());
+    pid_t child = fork();
+    if (child < 0)
+    {
+        cerr << "crash recovery: fork failed: " << strerror(errno) << "\n";
+        return false;
+    }
+    if (child == 0)
+    {
+        // the child only ever leaves through _exit, never back into the parent's code
+        try
+        {
+            PersistentQueue<Message> q(path, capacity, 0);
+            Message m = {};
+            for (long long i = 0;; i++)
+            {
+                m.id = i;
+                if (!q.try_push(m))
+                {
+                    Message out;
+                    while (q.getSize() > capacity / 2)
+                        q.try_pop(out);
+                    q.try_push(m);
+                }
+                if (i % 5000 == 4999)
+                    q.sync();
+            }
+        }
+        catch (const exception &e)
+        {
+            cerr << "crash recovery writer: " << e.what() << "\n";
+            _exit(1);
+        }
+        _exit(0);
+    }
+
+    usleep(300000);
+    kill(child, SIGKILL);
+    waitpid(child, nullptr, 0);
+
+    PersistentQueue<Message> q(path, capacity);
+    Message m;
+    long long expected = -1, count = 0;
+    bool ok = true;
+    while (q.try_pop(m))
+    {
+        if (expected >= 0 && m.id != expected)
+            ok = false;
+        expected = m.id + 1;
+        count++;
+    }
+    cout << "crash recovery: " << count << " records recovered, last id " << expected - 1
+         << (ok ? ", no gaps\n" : ", GAP DETECTED\n");
+    return ok;
+}
+
+void writeSpool(const string &path, int ringCapacity, int count)
+{
+    ::remove(path.c_str());
+    PersistentQueue<Message> q(path, ringCapacity);
+    Message m = {};
+    for (int i = 0; i < count; i++)
+    {
+        // a payload of zeros would survive a cut that the file is padded back from
+        m.id = i;
+        memset(m.payload, 'a' + i % 26, sizeof(m.payload));
+        q.add(m);
+    }
+}
+
+// reopens the spool and checks that it holds exactly ids 0..count-1 (popping them)
+bool holdsFirst(const string &path, int ringCapacity, long long count)
+{
+    PersistentQueue<Message> q(path, ringCapacity);
+    Message m;
+    long long next = 0;
+    while (q.try_pop(m))
+    {
+        if (m.id != next)
+            return false;
+        next++;
+    }
+    return next == count;
+}
+
+// Damage that SIGKILL cannot produce: the last record half overwritten, as if the
+// machine died while writing it, and the file cut off in the middle of a record.
+// Recovery must drop exactly the damaged tail and keep everything before it.
+bool tornTail(const string &path)
+{
+    const int ringCapacity = 1000, written = 100, cut = 60;
+    writeSpool(path, ringCapacity, written);
+    char garbage[16];
+    memset(garbage, 0x5a, sizeof(garbage));
+    int fd = open(path.c_str(), O_WRONLY);
+    bool ok = fd >= 0 && pwrite(fd, garbage, sizeof(garbage),
+                                (off_t)(PersistentQueue<Message>::slotOffset(written - 1) +
+                                        PersistentQueue<Message>::slotSize() / 2)) == (ssize_t)sizeof(garbage);
+    if (fd >= 0)
+        close(fd);
+    bool torn = ok && holdsFirst(path, ringCapacity, written - 1);
+
+    writeSpool(path, ringCapacity, written);
+    off_t middle = (off_t)(PersistentQueue<Message>::slotOffset(cut) + PersistentQueue<Message>::slotSize() / 2);
+    bool truncated = truncate(path.c_str(), middle) == 0 && holdsFirst(path, ringCapacity, cut);
+
+    cout << "torn last record: " << (torn ? "dropped, the rest kept" : "FAILED")
+         << "; file cut mid-record: " << (truncated ? "dropped from the cut on" : "FAILED") << '\n';
+    return torn && truncated;
+}
+
+int main(int argc, char *argv[])
+{
+    string path = argc > 1 ? argv[1] : "spool.bin";
+    throughput(path, 0);
+    throughput(path, 65536);
+    throughput(path, 4096);
+    bool ok = crashRecovery(path);
+    ok = tornTail(path) && ok;
+    ::remove(path.c_str());
+    return ok ? 0 : 1;
+}
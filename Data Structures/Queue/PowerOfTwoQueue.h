@@ -0,0 +1,267 @@
+#ifndef POWEROFTWOQUEUE_H
+#define POWEROFTWOQUEUE_H
+
+#include <memory>
+#include <new>
+#include <utility>
+#include "QueueException.h"
+
+// Circular queue whose capacity is a power of two. head and tail are free-running
+// unsigned counters: the slot is counter & mask, the size is tail - head, and
+// unsigned overflow wraps both consistently, so there is no modulo and no size field.
+// With fixedCapacity != 0 the mask is a compile-time constant; otherwise the
+// capacity passed to the constructor is rounded up to the next power of two.
+template <typename T, unsigned int fixedCapacity = 0>
+class PowerOfTwoQueue
+{
+private:
+    static_assert((fixedCapacity & (fixedCapacity - 1)) == 0, "fixedCapacity must be a power of two");
+
+    T *a;
+    unsigned int head;
+    unsigned int tail;
+    unsigned int runtimeMask;
+
+    unsigned int mask() const
+    {
+        return fixedCapacity != 0 ? fixedCapacity - 1 : runtimeMask;
+    }
+
+    // a moved-from queue has no storage and, like Queue, a capacity of 0
+    unsigned int capacity() const
+    {
+        if (fixedCapacity != 0)
+            return a != nullptr ? fixedCapacity : 0;
+        return runtimeMask + 1;
+    }
+
+    void release()
+    {
+        destroyAll();
+        if (a != nullptr)
+            allocator<T>().deallocate(a, capacity());
+    }
+
+    // takes q's storage and leaves q empty with capacity 0
+    void steal(PowerOfTwoQueue &q)
+    {
+        a = q.a;
+        head = q.head;
+        tail = q.tail;
+        runtimeMask = q.runtimeMask;
+        q.a = nullptr;
+        q.head = q.tail = 0;
+        q.runtimeMask = ~0u;
+    }
+
+    static unsigned int roundUp(int c)
+    {
+        unsigned int n = 1;
+        while (n < (unsigned int)c)
+            n <<= 1;
+        return n;
+    }
+
+    void destroyAll()
+    {
+        for (unsigned int i = head; i != tail; i++)
+        {
+            a[i & mask()].~T();
+        }
+        head = tail = 0;
+    }
+
+public:
+    PowerOfTwoQueue(int c = fixedCapacity)
+    {
+        if (c < 1)
+        {
+            throw QueueException("Capacity must be positive");
+        }
+        unsigned int capacity = fixedCapacity != 0 ? fixedCapacity : roundUp(c);
+        runtimeMask = capacity - 1;
+        a = allocator<T>().allocate(capacity);
+        head = tail = 0;
+    }
+
+    PowerOfTwoQueue(const PowerOfTwoQueue &q)
+    {
+        runtimeMask = q.runtimeMask;
+        a = q.a != nullptr ? allocator<T>().allocate(q.capacity()) : nullptr;
+        head = tail = 0;
+        try
+        {
+            for (unsigned int i = q.head; i != q.tail; i++)
+            {
+                new (&a[tail]) T(q.a[i & q.mask()]);
+                tail++;
+            }
+        }
+        catch (...)
+        {
+            release();
+            throw;
+        }
+    }
+
+    PowerOfTwoQueue(PowerOfTwoQueue &&q) noexcept
+    {
+        steal(q);
+    }
+
+    PowerOfTwoQueue &operator=(const PowerOfTwoQueue &q)
+    {
+        if (this != &q)
+        {
+            PowerOfTwoQueue copy(q);
+            swap(a, copy.a);
+            swap(head, copy.head);
+            swap(tail, copy.tail);
+            swap(runtimeMask, copy.runtimeMask);
+        }
+        return *this;
+    }
+
+    PowerOfTwoQueue &operator=(PowerOfTwoQueue &&q) noexcept
+    {
+        if (this != &q)
+        {
+            release();
+            steal(q);
+        }
+        return *this;
+    }
+
+    ~PowerOfTwoQueue()
+    {
+        release();
+    }
+
+    bool isFull() const
+    {
+        return tail - head == capacity();
+    }
+
+    bool isEmpty() const
+    {
+        return tail == head;
+    }
+
+    template <typename... Args>
+    T &emplace(Args &&...args)
+    {
+        if (isFull())
+        {
+            throw QueueException("Queue is full");
+        }
+
+        T *slot = new (&a[tail & mask()]) T(forward<Args>(args)...);
+        tail++;
+        return *slot;
+    }
+
+    void add(const T &item)
+    {
+        emplace(item);
+    }
+
+    void push(const T &item)
+    {
+        emplace(item);
+    }
+
+    void push(T &&item)
+    {
+        emplace(move(item));
+    }
+
+    void remove()
+    {
+        if (isEmpty())
+        {
+            throw QueueException("Queue is empty");
+        }
+
+        a[head & mask()].~T();
+        head++;
+    }
+
+    T pop()
+    {
+        if (isEmpty())
+        {
+            throw QueueException("Queue is empty");
+        }
+
+        T item(move(a[head & mask()]));
+        remove();
+        return item;
+    }
+
+    T &frontValue()
+    {
+        if (isEmpty())
+        {
+            throw QueueException("Queue is empty");
+        }
+        return a[head & mask()];
+    }
+
+    const T &frontValue() const
+    {
+        if (isEmpty())
+        {
+            throw QueueException("Queue is empty");
+        }
+        return a[head & mask()];
+    }
+
+    int getSize() const
+    {
+        return (int)(tail - head);
+    }
+
+    int getCapacity() const
+    {
+        return (int)capacity();
+    }
+
+    void clear()
+    {
+        destroyAll();
+    }
+
+    void print() const
+    {
+        if (isEmpty())
+        {
+            cout << "Queue is empty\n";
+            return;
+        }
+        cout << "Queue: ";
+        for (unsigned int i = head; i != tail; ++i)
+        {
+            cout << a[i & mask()] << ' ';
+        }
+        cout << '\n';
+    }
+
+    bool operator==(const PowerOfTwoQueue &other) const
+    {
+        if (getSize() != other.getSize() || getCapacity() != other.getCapacity())
+            return false;
+        for (unsigned int i = 0; i != tail - head; ++i)
+        {
+            if (a[(head + i) & mask()] != other.a[(other.head + i) & other.mask()])
+                return false;
+        }
+        return true;
+    }
+
+    bool operator!=(const PowerOfTwoQueue &other) const
+    {
+        return !(*this == other);
+    }
+};
+
+#endif
@@ -0,0 +1,63 @@
+#include <iostream>
+#include <chrono>
+#include "Queue.h"
+#include "PowerOfTwoQueue.h"
+using namespace std;
+
+const int operations = 50000000;
+const int capacity = 1024;
+const int depth = 512;
+
+template <int N>
+struct Payload
+{
+    int bytes[N / sizeof(int)];
+
+    Payload(int v = 0)
+    {
+        bytes[0] = v;
+    }
+};
+
+template <typename Q>
+double churn(Q &q, long long &sum)
+{
+    for (int i = 0; i < depth; i++)
+        q.emplace(i);
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < operations; i++)
+    {
+        sum += q.frontValue().bytes[0];
+        q.remove();
+        q.emplace(i);
+    }
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+template <int N>
+void run()
+{
+    long long sum = 0;
+    Queue<Payload<N>> modulo(capacity);
+    PowerOfTwoQueue<Payload<N>> runtimeMask(capacity);
+    PowerOfTwoQueue<Payload<N>, capacity> fixedMask;
+
+    double t1 = churn(modulo, sum);
+    double t2 = churn(runtimeMask, sum);
+    double t3 = churn(fixedMask, sum);
+
+    cout << N << "-byte elements: modulo " << operations / t1 / 1e6
+         << " M ops/s, runtime mask " << operations / t2 / 1e6
+         << " M ops/s, compile-time mask " << operations / t3 / 1e6 << " M ops/s"
+         << (sum == 0 ? " " : "") << '\n';
+}
+
+int main()
+{
+    run<4>();
+    run<16>();
+    run<64>();
+    run<256>();
+    return 0;
+}
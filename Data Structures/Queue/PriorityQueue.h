@@ -0,0 +1,299 @@
+#ifndef PRIORITYQUEUE_H
+#define PRIORITYQUEUE_H
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "QueueException.h"
+
+// d-ary min-heap over a contiguous array (4 children per node by default, so a
+// node's children usually share a cache line). push returns a handle that stays
+// valid until the element leaves the heap and can be used to change its key.
+// A handle is a slot number in the low 32 bits and the slot's generation in the high
+// 32. Slots are reused, but every time an element leaves, its slot's generation moves
+// on, so a stale handle is refused instead of reaching the slot's next element.
+template <typename T, typename Compare = less<T>, int D = 4>
+class PriorityQueue
+{
+public:
+    typedef long long Handle;
+
+private:
+    static_assert(D >= 2, "a heap needs at least two children per node");
+
+    struct Entry
+    {
+        T value;
+        int slot;
+    };
+
+    vector<Entry> heap;
+    vector<int> position;        // slot -> index in heap, -1 when free
+    vector<uint32_t> generation; // slot -> generation of the handle that owns it
+    vector<int> freeSlots;
+    Compare compare;
+
+    static uint32_t slotOf(Handle h)
+    {
+        return (uint32_t)((uint64_t)h & 0xFFFFFFFF);
+    }
+
+    Handle handleOf(int slot) const
+    {
+        return (Handle)(((uint64_t)generation[slot] << 32) | (uint64_t)slot);
+    }
+
+    void place(int index, Entry &&e)
+    {
+        position[e.slot] = index;
+        heap[index] = move(e);
+    }
+
+    void siftUp(int index)
+    {
+        Entry e = move(heap[index]);
+        while (index > 0)
+        {
+            int parent = (index - 1) / D;
+            if (!compare(e.value, heap[parent].value))
+                break;
+            place(index, move(heap[parent]));
+            index = parent;
+        }
+        place(index, move(e));
+    }
+
+    void siftDown(int index)
+    {
+        int n = (int)heap.size();
+        Entry e = move(heap[index]);
+        while (true)
+        {
+            int first = index * D + 1;
+            if (first >= n)
+                break;
+            int last = first + D < n ? first + D : n;
+            int best = first;
+            for (int c = first + 1; c < last; c++)
+            {
+                if (compare(heap[c].value, heap[best].value))
+                    best = c;
+            }
+            if (!compare(heap[best].value, e.value))
+                break;
+            place(index, move(heap[best]));
+            index = best;
+        }
+        place(index, move(e));
+    }
+
+    int newSlot()
+    {
+        if (!freeSlots.empty())
+        {
+            int slot = freeSlots.back();
+            freeSlots.pop_back();
+            return slot;
+        }
+        position.push_back(-1);
+        generation.push_back(0);
+        return (int)position.size() - 1;
+    }
+
+    void freeSlot(int slot)
+    {
+        position[slot] = -1;
+        generation[slot]++;
+        freeSlots.push_back(slot);
+    }
+
+    void removeTop()
+    {
+        freeSlot(heap[0].slot);
+        if (heap.size() > 1)
+        {
+            heap[0] = move(heap.back());
+            heap.pop_back();
+            siftDown(0);
+        }
+        else
+        {
+            heap.pop_back();
+        }
+    }
+
+public:
+    PriorityQueue(const Compare &c = Compare()) : compare(c) {}
+
+    // builds the heap from [first, last) bottom-up in O(n); on a new queue the handles
+    // are 0..n-1 in input order
+    template <typename It>
+    PriorityQueue(It first, It last, const Compare &c = Compare()) : compare(c)
+    {
+        heapify(first, last);
+    }
+
+    template <typename It>
+    void heapify(It first, It last)
+    {
+        clear();
+        for (; first != last; ++first)
+        {
+            int slot = newSlot();
+            position[slot] = (int)heap.size();
+            heap.push_back(Entry{*first, slot});
+        }
+        for (int i = ((int)heap.size() - 2) / D; i >= 0; i--)
+        {
+            siftDown(i);
+        }
+    }
+
+    bool isEmpty() const
+    {
+        return heap.empty();
+    }
+
+    int getSize() const
+    {
+        return (int)heap.size();
+    }
+
+    // false for handles whose element has left the heap, even if the slot is in use again
+    bool contains(Handle h) const
+    {
+        uint32_t slot = slotOf(h);
+        return slot < position.size() && position[slot] >= 0 && handleOf((int)slot) == h;
+    }
+
+    Handle push(const T &value)
+    {
+        int slot = newSlot();
+        position[slot] = (int)heap.size();
+        heap.push_back(Entry{value, slot});
+        siftUp((int)heap.size() - 1);
+        return handleOf(slot);
+    }
+
+    Handle push(T &&value)
+    {
+        int slot = newSlot();
+        position[slot] = (int)heap.size();
+        heap.push_back(Entry{move(value), slot});
+        siftUp((int)heap.size() - 1);
+        return handleOf(slot);
+    }
+
+    // non-throwing variants: false when the heap is empty or the handle is stale
+    bool try_top(T &out) const
+    {
+        if (heap.empty())
+            return false;
+        out = heap[0].value;
+        return true;
+    }
+
+    bool try_pop(T &out)
+    {
+        if (heap.empty())
+            return false;
+        out = move(heap[0].value);
+        removeTop();
+        return true;
+    }
+
+    bool try_update(Handle h, const T &value)
+    {
+        if (!contains(h))
+            return false;
+        int index = position[slotOf(h)];
+        bool up = compare(value, heap[index].value);
+        heap[index].value = value;
+        if (up)
+            siftUp(index);
+        else
+            siftDown(index);
+        return true;
+    }
+
+    // only moves the element toward the top; fails if value would move it down
+    bool try_decrease_key(Handle h, const T &value)
+    {
+        if (!contains(h))
+            return false;
+        int index = position[slotOf(h)];
+        if (compare(heap[index].value, value))
+            return false;
+        heap[index].value = value;
+        siftUp(index);
+        return true;
+    }
+
+    const T &top() const
+    {
+        if (heap.empty())
+        {
+            throw QueueException("Queue is empty");
+        }
+        return heap[0].value;
+    }
+
+    Handle topHandle() const
+    {
+        if (heap.empty())
+        {
+            throw QueueException("Queue is empty");
+        }
+        return handleOf(heap[0].slot);
+    }
+
+    T pop()
+    {
+        T value;
+        if (!try_pop(value))
+        {
+            throw QueueException("Queue is empty");
+        }
+        return value;
+    }
+
+    const T &get(Handle h) const
+    {
+        if (!contains(h))
+        {
+            throw QueueException("Invalid handle");
+        }
+        return heap[position[slotOf(h)]].value;
+    }
+
+    void update(Handle h, const T &value)
+    {
+        if (!try_update(h, value))
+        {
+            throw QueueException("Invalid handle");
+        }
+    }
+
+    void decrease_key(Handle h, const T &value)
+    {
+        if (!contains(h))
+        {
+            throw QueueException("Invalid handle");
+        }
+        if (!try_decrease_key(h, value))
+        {
+            throw QueueException("New key would move the element down");
+        }
+    }
+
+    // the slots stay, with their generations moved on, so old handles stay refused
+    void clear()
+    {
+        for (const Entry &e : heap)
+            freeSlot(e.slot);
+        heap.clear();
+    }
+};
+
+#endif
@@ -0,0 +1,73 @@
+#include <iostream>
+#include <queue>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include "PriorityQueue.h"
+using namespace std;
+
+double seconds(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void run(int n)
+{
+    mt19937 rng(n);
+    vector<int> keys(n);
+    for (int &k : keys)
+        k = (int)(rng() >> 1);
+    long long sum1 = 0, sum2 = 0;
+
+    auto start = chrono::steady_clock::now();
+    priority_queue<int, vector<int>, greater<int>> stdHeap;
+    for (int k : keys)
+        stdHeap.push(k);
+    while (!stdHeap.empty())
+    {
+        sum1 += stdHeap.top();
+        stdHeap.pop();
+    }
+    double stdTime = seconds(start);
+
+    start = chrono::steady_clock::now();
+    PriorityQueue<int> heap;
+    for (int k : keys)
+        heap.push(k);
+    int value;
+    while (heap.try_pop(value))
+        sum2 += value;
+    double dAryTime = seconds(start);
+
+    start = chrono::steady_clock::now();
+    priority_queue<int, vector<int>, greater<int>> stdBuilt(greater<int>(), keys);
+    double stdBuild = seconds(start);
+
+    start = chrono::steady_clock::now();
+    PriorityQueue<int> built(keys.begin(), keys.end());
+    double dAryBuild = seconds(start);
+
+    // deadline rescheduling: move a random element earlier
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < n; i++)
+    {
+        int h = (int)(rng() % n);
+        built.decrease_key(h, built.get(h) / 2);
+    }
+    double decrease = seconds(start);
+
+    cout << "n=" << n << "  push+pop: std " << stdTime << " s, 4-ary " << dAryTime
+         << " s | build: std " << stdBuild << " s, heapify " << dAryBuild
+         << " s | " << n << " decrease_key " << decrease << " s"
+         << (sum1 == sum2 && stdBuilt.size() == (size_t)built.getSize() ? "" : "  MISMATCH") << '\n';
+}
+
+int main(int argc, char *argv[])
+{
+    int maxExponent = argc > 1 ? atoi(argv[1]) : 7;
+    int n = 1000;
+    for (int e = 3; e <= maxExponent; e++, n *= 10)
+        run(n);
+    return 0;
+}
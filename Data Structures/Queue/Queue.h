@@ -1,6 +1,25 @@
+#ifndef QUEUE_H
+#define QUEUE_H
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#if __cplusplus >= 202002L
+#include <span>
+#endif
 #include "QueueException.h"
+#include "QueueStats.h"
 
-template <typename T>
+// Slots are raw, uninitialized storage: an element is constructed when it is added
+// and destroyed when it is removed, so only the live range [front, front + size)
+// ever holds objects.
+// Stats is a statistics policy from QueueStats.h; the default records nothing. The
+// statistics travel with the elements: a copy or a move starts from the source's
+// counters, and a moved-from queue starts over.
+template <typename T, typename Stats = NoQueueStats>
 class Queue
 {
 private:
@@ -9,51 +28,214 @@ private:
     int rear;
     int size;
     unsigned int capacity;
+    Stats stats;
+    uint64_t *stamps; // enqueue time per slot, only when Stats::timed
+
+    static T *allocate(unsigned int n)
+    {
+        return allocator<T>().allocate(n);
+    }
+
+    static void deallocate(T *p, unsigned int n)
+    {
+        if (p != nullptr)
+            allocator<T>().deallocate(p, n);
+    }
+
+    void stamp(int index)
+    {
+        if constexpr (Stats::timed)
+            stamps[index] = Stats::now();
+    }
+
+    void recordWait(int index)
+    {
+        if constexpr (Stats::timed)
+            stats.waited(Stats::now() - stamps[index]);
+    }
+
+    // copies the live elements of q to the start of this queue's (empty) storage
+    void copyFrom(const Queue &q)
+    {
+        for (int i = 0; i < q.size; i++)
+        {
+            int index = (q.front + i) % q.capacity;
+            new (&a[i]) T(q.a[index]);
+            if constexpr (Stats::timed)
+                stamps[i] = q.stamps[index];
+            size = i + 1;
+        }
+        front = 0;
+        rear = size - 1;
+    }
+
+    // constructs n elements in raw slots
+    static void constructFrom(T *dst, const T *src, int n)
+    {
+        if constexpr (is_trivially_copyable<T>::value)
+        {
+            if (n > 0)
+                memcpy(static_cast<void *>(dst), src, n * sizeof(T));
+        }
+        else
+        {
+            uninitialized_copy(src, src + n, dst);
+        }
+    }
+
+    // Moves the n front elements into existing objects at dst and removes them. Each
+    // element leaves the queue as soon as it has been moved, so a throwing
+    // move-assignment leaves exactly the elements not yet moved out.
+    void moveOut(T *dst, int n)
+    {
+        if constexpr (is_trivially_copyable<T>::value)
+        {
+            int first = min(n, (int)capacity - front);
+            memcpy(static_cast<void *>(dst), a + front, first * sizeof(T));
+            memcpy(static_cast<void *>(dst + first), a, (n - first) * sizeof(T));
+            if constexpr (Stats::timed)
+            {
+                for (int i = 0; i < n; i++)
+                    recordWait((front + i) % capacity);
+            }
+            front = (front + n) % capacity;
+            size -= n;
+        }
+        else
+        {
+            for (int i = 0; i < n; i++)
+            {
+                dst[i] = move(a[front]);
+                recordWait(front);
+                a[front].~T();
+                front = (front + 1) % capacity;
+                size--;
+            }
+        }
+    }
+
+    static void copyOut(T *dst, const T *src, int n)
+    {
+        if constexpr (is_trivially_copyable<T>::value)
+        {
+            if (n > 0)
+                memcpy(static_cast<void *>(dst), src, n * sizeof(T));
+        }
+        else
+        {
+            copy(src, src + n, dst);
+        }
+    }
+
+    void destroyAll()
+    {
+        for (int i = 0; i < size; i++)
+        {
+            a[(front + i) % capacity].~T();
+        }
+        front = 0;
+        rear = -1;
+        size = 0;
+    }
 
 public:
+    // the live elements as at most two contiguous runs, front first
+    struct Segments
+    {
+        T *first;
+        int firstSize;
+        T *second;
+        int secondSize;
+    };
+
     Queue(int c)
     {
         capacity = c;
-        a = new T[capacity];
+        a = allocate(capacity);
+        stamps = Stats::timed ? new uint64_t[capacity] : nullptr;
         front = 0;
         rear = -1;
         size = 0;
     }
 
-    Queue(const Queue &q)
+    Queue(const Queue &q) : stats(q.stats)
     {
         capacity = q.capacity;
-        a = new T[capacity];
+        a = allocate(capacity);
+        stamps = Stats::timed ? new uint64_t[capacity] : nullptr;
+        front = 0;
+        rear = -1;
+        size = 0;
+        try
+        {
+            copyFrom(q);
+        }
+        catch (...)
+        {
+            destroyAll();
+            deallocate(a, capacity);
+            delete[] stamps;
+            throw;
+        }
+    }
+
+    Queue(Queue &&q) noexcept : stats(q.stats)
+    {
+        a = q.a;
+        stamps = q.stamps;
         front = q.front;
         rear = q.rear;
         size = q.size;
-        for (int i = 0; i < capacity; i++)
+        capacity = q.capacity;
+        q.a = nullptr;
+        q.stamps = nullptr;
+        q.front = 0;
+        q.rear = -1;
+        q.size = 0;
+        q.capacity = 0;
+        q.stats.reset();
+    }
+
+    Queue &operator=(const Queue &q)
+    {
+        if (this != &q)
         {
-            a[i] = q.a[i];
+            Queue copy(q);
+            *this = move(copy);
         }
+        return *this;
     }
 
-    Queue &operator=(const Queue &q)
+    Queue &operator=(Queue &&q) noexcept
     {
         if (this != &q)
         {
-            delete[] a;
-            capacity = q.capacity;
+            destroyAll();
+            deallocate(a, capacity);
+            delete[] stamps;
+            a = q.a;
+            stamps = q.stamps;
             front = q.front;
             rear = q.rear;
             size = q.size;
-            a = new T[capacity];
-            for (int i = 0; i < capacity; i++)
-            {
-                a[i] = q.a[i];
-            }
+            capacity = q.capacity;
+            stats = q.stats;
+            q.a = nullptr;
+            q.stamps = nullptr;
+            q.front = 0;
+            q.rear = -1;
+            q.size = 0;
+            q.capacity = 0;
+            q.stats.reset();
         }
         return *this;
     }
 
     ~Queue()
     {
-        delete[] a;
+        destroyAll();
+        deallocate(a, capacity);
+        delete[] stamps;
     }
 
     bool isFull() const
@@ -66,31 +248,256 @@ public:
         return size == 0;
     }
 
-    void add(T item)
+    // The try_ functions report a full or empty queue through their return value;
+    // the throwing functions below are thin wrappers around them.
+    template <typename... Args>
+    bool try_emplace(Args &&...args)
     {
         if (isFull())
+        {
+            stats.rejectedFull();
+            return false;
+        }
+
+        int next = (rear + 1) % capacity;
+        new (&a[next]) T(forward<Args>(args)...);
+        stamp(next);
+        rear = next;
+        size += 1;
+        stats.pushed(1, size);
+        return true;
+    }
+
+    bool try_push(const T &item)
+    {
+        return try_emplace(item);
+    }
+
+    bool try_push(T &&item)
+    {
+        return try_emplace(move(item));
+    }
+
+    bool try_remove()
+    {
+        if (isEmpty())
+        {
+            stats.rejectedEmpty();
+            return false;
+        }
+
+        recordWait(front);
+        a[front].~T();
+        front = (front + 1) % capacity;
+        size--;
+        stats.popped(1);
+        return true;
+    }
+
+    bool try_pop(T &out)
+    {
+        if (isEmpty())
+        {
+            stats.rejectedEmpty();
+            return false;
+        }
+
+        out = move(a[front]);
+        return try_remove();
+    }
+
+    bool try_front(T &out) const
+    {
+        if (isEmpty())
+            return false;
+
+        out = a[front];
+        return true;
+    }
+
+    template <typename... Args>
+    T &emplace(Args &&...args)
+    {
+        if (!try_emplace(forward<Args>(args)...))
         {
             throw QueueException("Queue is full");
         }
+        return a[rear];
+    }
+
+    void add(const T &item)
+    {
+        emplace(item);
+    }
 
-        rear = (rear + 1) % capacity;
+    void push(const T &item)
+    {
+        emplace(item);
+    }
 
-        a[rear] = item;
-        size += 1;
+    void push(T &&item)
+    {
+        emplace(move(item));
     }
 
     void remove()
+    {
+        if (!try_remove())
+        {
+            throw QueueException("Queue is empty");
+        }
+    }
+
+    // moves the front element out and removes it
+    T pop()
     {
         if (isEmpty())
         {
+            stats.rejectedEmpty();
             throw QueueException("Queue is empty");
         }
 
-        front = (front + 1) % capacity;
-        size--;
+        T item(move(a[front]));
+        remove();
+        return item;
     }
 
-    T frontValue() const
+    // appends up to count items and returns how many fit
+    int push_bulk(const T *items, int count)
+    {
+        int n = min(count, (int)capacity - size);
+        if (n <= 0)
+        {
+            if (count > 0)
+                stats.rejectedFull();
+            return 0;
+        }
+
+        int start = (rear + 1) % capacity;
+        int first = min(n, (int)capacity - start);
+        constructFrom(a + start, items, first);
+        try
+        {
+            constructFrom(a, items + first, n - first);
+        }
+        catch (...)
+        {
+            for (int i = 0; i < first; i++)
+                a[start + i].~T();
+            throw;
+        }
+        if constexpr (Stats::timed)
+        {
+            for (int i = 0; i < n; i++)
+                stamp((start + i) % capacity);
+        }
+        rear = (start + n - 1) % capacity;
+        size += n;
+        stats.pushed(n, size);
+        return n;
+    }
+
+    // moves up to count front elements into out and returns how many were removed
+    int pop_bulk(T *out, int count)
+    {
+        int n = min(count, size);
+        if (n <= 0)
+        {
+            if (count > 0)
+                stats.rejectedEmpty();
+            return 0;
+        }
+
+        int before = size;
+        try
+        {
+            moveOut(out, n);
+        }
+        catch (...)
+        {
+            stats.popped(before - size);
+            throw;
+        }
+        stats.popped(n);
+        return n;
+    }
+
+    // copies up to count front elements into out without removing them
+    int peek_bulk(T *out, int count) const
+    {
+        int n = min(count, size);
+        if (n <= 0)
+            return 0;
+
+        int first = min(n, (int)capacity - front);
+        copyOut(out, a + front, first);
+        copyOut(out + first, a, n - first);
+        return n;
+    }
+
+    // drops up to count front elements, e.g. after processing readable_segments() in place
+    int remove_bulk(int count)
+    {
+        int n = min(count, size);
+        if (n <= 0)
+        {
+            if (count > 0)
+                stats.rejectedEmpty();
+            return 0;
+        }
+
+        if (Stats::timed || !is_trivially_destructible<T>::value)
+        {
+            for (int i = 0; i < n; i++)
+            {
+                recordWait((front + i) % capacity);
+                a[(front + i) % capacity].~T();
+            }
+        }
+        front = (front + n) % capacity;
+        size -= n;
+        stats.popped(n);
+        return n;
+    }
+
+    Segments readable_segments()
+    {
+        Segments s;
+        int first = min(size, (int)capacity - front);
+        s.first = a + front;
+        s.firstSize = first;
+        s.second = a;
+        s.secondSize = size - first;
+        return s;
+    }
+
+#if __cplusplus >= 202002L
+    int push_bulk(span<const T> items)
+    {
+        return push_bulk(items.data(), (int)items.size());
+    }
+
+    int pop_bulk(span<T> out)
+    {
+        return pop_bulk(out.data(), (int)out.size());
+    }
+
+    int peek_bulk(span<T> out) const
+    {
+        return peek_bulk(out.data(), (int)out.size());
+    }
+#endif
+
+    T &frontValue()
+    {
+        if (isEmpty())
+        {
+            throw QueueException("Queue is empty");
+        }
+        return a[front];
+    }
+
+    const T &frontValue() const
     {
         if (isEmpty())
         {
@@ -109,11 +516,19 @@ public:
         return capacity;
     }
 
+    const Stats &getStats() const
+    {
+        return stats;
+    }
+
+    Stats &getStats()
+    {
+        return stats;
+    }
+
     void clear()
     {
-        front = 0;
-        rear = -1;
-        size = 0;
+        destroyAll();
     }
 
     void print() const
@@ -151,3 +566,5 @@ public:
         return !(*this == other);
     }
 };
+
+#endif
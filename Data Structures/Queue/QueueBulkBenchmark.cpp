@@ -0,0 +1,78 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include "Queue.h"
+using namespace std;
+
+const long long totalItems = 100000000;
+const int capacity = 8192;
+
+double seconds(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void run(int batch)
+{
+    Queue<int> q(capacity);
+    vector<int> in(batch), out(batch);
+    for (int i = 0; i < batch; i++)
+        in[i] = i;
+    long long rounds = totalItems / batch;
+    long long sum = 0;
+
+    // offset the ring so batches regularly straddle the wrap-around point
+    for (int i = 0; i < capacity / 3; i++)
+    {
+        q.add(i);
+        q.remove();
+    }
+
+    auto start = chrono::steady_clock::now();
+    for (long long r = 0; r < rounds; r++)
+    {
+        for (int i = 0; i < batch; i++)
+            q.add(in[i]);
+        for (int i = 0; i < batch; i++)
+        {
+            out[i] = q.frontValue();
+            q.remove();
+        }
+        sum += out[batch - 1];
+    }
+    double single = seconds(start);
+
+    start = chrono::steady_clock::now();
+    for (long long r = 0; r < rounds; r++)
+    {
+        q.push_bulk(in.data(), batch);
+        q.pop_bulk(out.data(), batch);
+        sum += out[batch - 1];
+    }
+    double bulk = seconds(start);
+
+    start = chrono::steady_clock::now();
+    for (long long r = 0; r < rounds; r++)
+    {
+        q.push_bulk(in.data(), batch);
+        Queue<int>::Segments s = q.readable_segments();
+        for (int i = 0; i < s.firstSize; i++)
+            sum += s.first[i];
+        for (int i = 0; i < s.secondSize; i++)
+            sum += s.second[i];
+        q.remove_bulk(batch);
+    }
+    double inPlace = seconds(start);
+
+    cout << "batch " << batch << ": add/remove " << totalItems / single / 1e6
+         << " M/s, push_bulk/pop_bulk " << totalItems / bulk / 1e6
+         << " M/s, readable_segments " << totalItems / inPlace / 1e6 << " M/s"
+         << (sum == 0 ? " " : "") << '\n';
+}
+
+int main()
+{
+    for (int batch = 64; batch <= 4096; batch *= 4)
+        run(batch);
+    return 0;
+}
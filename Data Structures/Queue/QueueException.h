@@ -1,3 +1,6 @@
+#ifndef QUEUEEXCEPTION_H
+#define QUEUEEXCEPTION_H
+
 #include <iostream>
 #include <exception>
 using namespace std;
@@ -13,3 +16,5 @@ public:
         return message.c_str();
     }
 };
+
+#endif
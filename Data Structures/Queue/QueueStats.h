@@ -0,0 +1,188 @@
+#ifndef QUEUESTATS_H
+#define QUEUESTATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+using namespace std;
+
+// Statistics policies for Queue<T, Stats>. NoQueueStats compiles to nothing.
+// QueueStats counts enqueues, dequeues and rejections, tracks the high-water mark
+// and an occupancy histogram, and with timed = true also a histogram of how long
+// elements sat in the queue. Buckets are powers of two: bucket i holds values in
+// [2^(i-1), 2^i), bucket 0 holds zero. Timing costs a steady_clock read on every
+// add and remove, so it is priced separately from the counters.
+struct NoQueueStats
+{
+    static const bool timed = false;
+
+    static uint64_t now() { return 0; }
+    void pushed(int, int) {}
+    void popped(int) {}
+    void rejectedFull() {}
+    void rejectedEmpty() {}
+    void waited(uint64_t) {}
+    void reset() {}
+};
+
+template <bool timedStats = false>
+class QueueStats
+{
+public:
+    static const bool timed = timedStats;
+    static const int buckets = 40;
+
+private:
+    // Queue<T> itself is single-threaded, so each counter has one writer. A relaxed
+    // load + store is a plain add, unlike fetch_add, yet another thread can still
+    // read a consistent value of each counter while the queue runs.
+    typedef atomic<uint64_t> Counter;
+
+    Counter enqueues;
+    Counter dequeues;
+    Counter fullRejections;
+    Counter emptyRejections;
+    Counter highWater;
+    Counter occupancy[buckets];
+    Counter latencyNs[buckets];
+
+    static void bump(Counter &c, uint64_t n = 1)
+    {
+        c.store(c.load(memory_order_relaxed) + n, memory_order_relaxed);
+    }
+
+    static void copyCounter(Counter &c, const Counter &from)
+    {
+        c.store(from.load(memory_order_relaxed), memory_order_relaxed);
+    }
+
+    static int bucketOf(uint64_t v)
+    {
+#if defined(__GNUC__)
+        int b = v == 0 ? 0 : 64 - __builtin_clzll(v);
+        return b < buckets ? b : buckets - 1;
+#else
+        int b = 0;
+        while (v != 0 && b < buckets - 1)
+        {
+            v >>= 1;
+            b++;
+        }
+        return b;
+#endif
+    }
+
+    static void writeHistogram(ostream &out, const Counter *h)
+    {
+        out << '[';
+        for (int i = 0; i < buckets; i++)
+        {
+            out << (i ? "," : "") << h[i].load(memory_order_relaxed);
+        }
+        out << ']';
+    }
+
+public:
+    QueueStats()
+    {
+        reset();
+    }
+
+    // takes a snapshot of other's counters, so a Queue can carry its statistics along
+    QueueStats(const QueueStats &other)
+    {
+        *this = other;
+    }
+
+    QueueStats &operator=(const QueueStats &other)
+    {
+        copyCounter(enqueues, other.enqueues);
+        copyCounter(dequeues, other.dequeues);
+        copyCounter(fullRejections, other.fullRejections);
+        copyCounter(emptyRejections, other.emptyRejections);
+        copyCounter(highWater, other.highWater);
+        for (int i = 0; i < buckets; i++)
+        {
+            copyCounter(occupancy[i], other.occupancy[i]);
+            copyCounter(latencyNs[i], other.latencyNs[i]);
+        }
+        return *this;
+    }
+
+    static uint64_t now()
+    {
+        return (uint64_t)chrono::duration_cast<chrono::nanoseconds>(
+                   chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    // n elements were added and the queue now holds size
+    void pushed(int n, int size)
+    {
+        bump(enqueues, n);
+        bump(occupancy[bucketOf(size)]);
+        if ((uint64_t)size > highWater.load(memory_order_relaxed))
+            highWater.store(size, memory_order_relaxed);
+    }
+
+    void popped(int n)
+    {
+        bump(dequeues, n);
+    }
+
+    void rejectedFull()
+    {
+        bump(fullRejections);
+    }
+
+    void rejectedEmpty()
+    {
+        bump(emptyRejections);
+    }
+
+    void waited(uint64_t ns)
+    {
+        bump(latencyNs[bucketOf(ns)]);
+    }
+
+    uint64_t getEnqueues() const { return enqueues.load(memory_order_relaxed); }
+    uint64_t getDequeues() const { return dequeues.load(memory_order_relaxed); }
+    uint64_t getFullRejections() const { return fullRejections.load(memory_order_relaxed); }
+    uint64_t getEmptyRejections() const { return emptyRejections.load(memory_order_relaxed); }
+    uint64_t getHighWater() const { return highWater.load(memory_order_relaxed); }
+
+    void reset()
+    {
+        enqueues.store(0, memory_order_relaxed);
+        dequeues.store(0, memory_order_relaxed);
+        fullRejections.store(0, memory_order_relaxed);
+        emptyRejections.store(0, memory_order_relaxed);
+        highWater.store(0, memory_order_relaxed);
+        for (int i = 0; i < buckets; i++)
+        {
+            occupancy[i].store(0, memory_order_relaxed);
+            latencyNs[i].store(0, memory_order_relaxed);
+        }
+    }
+
+    // one JSON object per snapshot
+    void writeJson(ostream &out) const
+    {
+        out << "{\"enqueues\":" << getEnqueues()
+            << ",\"dequeues\":" << getDequeues()
+            << ",\"fullRejections\":" << getFullRejections()
+            << ",\"emptyRejections\":" << getEmptyRejections()
+            << ",\"highWater\":" << getHighWater()
+            << ",\"occupancyLog2\":";
+        writeHistogram(out, occupancy);
+        if (timed)
+        {
+            out << ",\"latencyNsLog2\":";
+            writeHistogram(out, latencyNs);
+        }
+        out << "}\n";
+    }
+};
+
+#endif
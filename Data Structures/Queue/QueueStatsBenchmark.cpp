@@ -0,0 +1,59 @@
+#include <iostream>
+#include <chrono>
+#include "Queue.h"
+using namespace std;
+
+const int operations = 50000000;
+const int capacity = 1000;
+
+template <typename Q>
+double churn(Q &q)
+{
+    long long sum = 0;
+    int value;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < operations; i++)
+    {
+        // occupancy drifts up and down, with occasional full and empty rejections
+        if ((i / 4096) % 2 == 0)
+        {
+            q.try_push(i);
+            q.try_push(i);
+            if (q.try_pop(value))
+                sum += value;
+        }
+        else
+        {
+            q.try_push(i);
+            if (q.try_pop(value))
+                sum += value;
+            if (q.try_pop(value))
+                sum += value;
+        }
+    }
+    double t = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (sum == 0)
+        cout << ' ';
+    return t;
+}
+
+int main()
+{
+    Queue<int> plain(capacity);
+    Queue<int, QueueStats<>> counted(capacity);
+    Queue<int, QueueStats<true>> timed(capacity);
+
+    double base = churn(plain);
+    double withStats = churn(counted);
+    double withTiming = churn(timed);
+
+    cout << "no stats:      " << operations / base / 1e6 << " M ops/s\n";
+    cout << "counters:      " << operations / withStats / 1e6 << " M ops/s ("
+         << (withStats / base - 1) * 100 << "% overhead)\n";
+    cout << "counters+time: " << operations / withTiming / 1e6 << " M ops/s ("
+         << (withTiming / base - 1) * 100 << "% overhead)\n";
+
+    counted.getStats().writeJson(cout);
+    timed.getStats().writeJson(cout);
+    return 0;
+}
@@ -0,0 +1,237 @@
+#ifndef SEGMENTEDQUEUE_H
+#define SEGMENTEDQUEUE_H
+
+#include <new>
+#include "QueueException.h"
+
+// Unbounded queue built from fixed-size chunks chained front to back, like a deque.
+// Growing links a new chunk at the rear, so existing elements are never copied, and
+// chunks are released as soon as the front walks off them. One empty chunk is kept
+// as a spare so a queue that hovers around a chunk boundary does not thrash the heap.
+// As in Queue, slots are raw storage: an element is constructed when it is added and
+// destroyed when it is removed.
+template <typename T, int chunkSize = 256>
+class SegmentedQueue
+{
+private:
+    struct Chunk
+    {
+        alignas(T) unsigned char storage[chunkSize * sizeof(T)];
+        Chunk *next;
+
+        Chunk() : next(nullptr) {}
+
+        T *items()
+        {
+            return (T *)(void *)storage;
+        }
+    };
+
+    Chunk *head;
+    Chunk *tail;
+    Chunk *spare;
+    int front;
+    int rear;
+    int size;
+    int chunks;
+
+    Chunk *newChunk()
+    {
+        Chunk *c;
+        if (spare != nullptr)
+        {
+            c = spare;
+            spare = nullptr;
+            c->next = nullptr;
+        }
+        else
+        {
+            c = new Chunk();
+        }
+        chunks++;
+        return c;
+    }
+
+    void releaseChunk(Chunk *c)
+    {
+        chunks--;
+        if (spare == nullptr)
+        {
+            spare = c;
+        }
+        else
+        {
+            delete c;
+        }
+    }
+
+    void copyFrom(const SegmentedQueue &q)
+    {
+        Chunk *c = q.head;
+        int index = q.front;
+        for (int i = 0; i < q.size; i++)
+        {
+            if (index == chunkSize)
+            {
+                c = c->next;
+                index = 0;
+            }
+            add(c->items()[index++]);
+        }
+    }
+
+public:
+    SegmentedQueue()
+    {
+        head = tail = nullptr;
+        spare = nullptr;
+        front = 0;
+        rear = chunkSize;
+        size = 0;
+        chunks = 0;
+    }
+
+    SegmentedQueue(const SegmentedQueue &q) : SegmentedQueue()
+    {
+        copyFrom(q);
+    }
+
+    SegmentedQueue &operator=(const SegmentedQueue &q)
+    {
+        if (this != &q)
+        {
+            clear();
+            copyFrom(q);
+        }
+        return *this;
+    }
+
+    ~SegmentedQueue()
+    {
+        clear();
+        delete spare;
+    }
+
+    bool isEmpty() const
+    {
+        return size == 0;
+    }
+
+    void add(const T &item)
+    {
+        if (rear == chunkSize)
+        {
+            Chunk *c = newChunk();
+            if (tail == nullptr)
+            {
+                head = tail = c;
+                front = 0;
+            }
+            else
+            {
+                tail->next = c;
+                tail = c;
+            }
+            rear = 0;
+        }
+        new (&tail->items()[rear]) T(item);
+        rear++;
+        size++;
+    }
+
+    void remove()
+    {
+        if (isEmpty())
+        {
+            throw QueueException("Queue is empty");
+        }
+
+        head->items()[front].~T();
+        front++;
+        size--;
+        if (size == 0)
+        {
+            // drained: keep nothing but the spare
+            releaseChunk(head);
+            head = tail = nullptr;
+            front = 0;
+            rear = chunkSize;
+        }
+        else if (front == chunkSize)
+        {
+            Chunk *old = head;
+            head = head->next;
+            front = 0;
+            releaseChunk(old);
+        }
+    }
+
+    T frontValue() const
+    {
+        if (isEmpty())
+        {
+            throw QueueException("Queue is empty");
+        }
+        return head->items()[front];
+    }
+
+    int getSize() const
+    {
+        return size;
+    }
+
+    // slots currently allocated to the queue, not counting the spare chunk
+    int getCapacity() const
+    {
+        return chunks * chunkSize;
+    }
+
+    void clear()
+    {
+        Chunk *c = head;
+        int index = front;
+        for (int i = 0; i < size; i++)
+        {
+            if (index == chunkSize)
+            {
+                c = c->next;
+                index = 0;
+            }
+            c->items()[index++].~T();
+        }
+        while (head != nullptr)
+        {
+            Chunk *next = head->next;
+            releaseChunk(head);
+            head = next;
+        }
+        tail = nullptr;
+        front = 0;
+        rear = chunkSize;
+        size = 0;
+    }
+
+    void print() const
+    {
+        if (isEmpty())
+        {
+            cout << "Queue is empty\n";
+            return;
+        }
+        cout << "Queue: ";
+        Chunk *c = head;
+        int index = front;
+        for (int i = 0; i < size; ++i)
+        {
+            if (index == chunkSize)
+            {
+                c = c->next;
+                index = 0;
+            }
+            cout << c->items()[index++] << ' ';
+        }
+        cout << '\n';
+    }
+};
+
+#endif
@@ -0,0 +1,76 @@
+#include <iostream>
+#include <chrono>
+#include "Queue.h"
+#include "SegmentedQueue.h"
+using namespace std;
+
+const int operations = 20000000;
+const int steadyDepth = 64;
+const int burstSize = 100000;
+
+template <typename Q>
+double steady(Q &q)
+{
+    long long sum = 0;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < steadyDepth; i++)
+        q.add(i);
+    for (int i = 0; i < operations; i++)
+    {
+        sum += q.frontValue();
+        q.remove();
+        q.add(i);
+    }
+    while (!q.isEmpty())
+        q.remove();
+    double t = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (sum < 0)
+        cout << sum;
+    return t;
+}
+
+template <typename Q>
+double bursty(Q &q, int &peakCapacity)
+{
+    long long sum = 0;
+    peakCapacity = 0;
+    auto start = chrono::steady_clock::now();
+    for (int round = 0; round < operations / burstSize; round++)
+    {
+        // bursts vary from a handful of items up to burstSize
+        int n = round % 10 == 0 ? burstSize : burstSize / 100;
+        for (int i = 0; i < n; i++)
+            q.add(i);
+        if (q.getCapacity() > peakCapacity)
+            peakCapacity = q.getCapacity();
+        while (!q.isEmpty())
+        {
+            sum += q.frontValue();
+            q.remove();
+        }
+    }
+    double t = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (sum < 0)
+        cout << sum;
+    return t;
+}
+
+int main()
+{
+    Queue<int> fixedSteady(steadyDepth);
+    SegmentedQueue<int> segmentedSteady;
+    cout << "steady  Queue:          " << steady(fixedSteady) << " s\n";
+    cout << "steady  SegmentedQueue: " << steady(segmentedSteady) << " s\n";
+
+    // the fixed queue has to be sized for the worst burst up front
+    Queue<int> fixedBursty(burstSize);
+    SegmentedQueue<int> segmentedBursty;
+    int fixedPeak, segmentedPeak;
+    double fixedTime = bursty(fixedBursty, fixedPeak);
+    double segmentedTime = bursty(segmentedBursty, segmentedPeak);
+    cout << "bursty  Queue:          " << fixedTime << " s, capacity " << fixedPeak
+         << ", after drain " << fixedBursty.getCapacity() << '\n';
+    cout << "bursty  SegmentedQueue: " << segmentedTime << " s, peak capacity " << segmentedPeak
+         << ", after drain " << segmentedBursty.getCapacity() << '\n';
+    return 0;
+}
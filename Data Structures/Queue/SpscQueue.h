@@ -0,0 +1,155 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include "QueueException.h"
+
+// Lock-free circular queue for exactly one producer thread and one consumer thread.
+// head is written only by the consumer and tail only by the producer; each lives on
+// its own cache line together with that side's cached copy of the other index.
+// As in Queue.h the slots are raw storage: the producer constructs an element in
+// place and the consumer destroys it, so T needs no default constructor.
+template <typename T>
+class SpscQueue
+{
+private:
+    static const size_t cacheLine = 64;
+
+    T *a;
+    size_t capacity;
+
+    alignas(cacheLine) atomic<size_t> head;
+    size_t cachedTail;
+
+    alignas(cacheLine) atomic<size_t> tail;
+    size_t cachedHead;
+
+    size_t next(size_t index) const
+    {
+        return index + 1 == capacity ? 0 : index + 1;
+    }
+
+public:
+    SpscQueue(int c)
+    {
+        if (c < 1)
+        {
+            throw QueueException("Capacity must be positive");
+        }
+        // one slot stays empty so that head == tail always means "empty"
+        capacity = c + 1;
+        a = allocator<T>().allocate(capacity);
+        head.store(0, memory_order_relaxed);
+        tail.store(0, memory_order_relaxed);
+        cachedTail = 0;
+        cachedHead = 0;
+    }
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    ~SpscQueue()
+    {
+        size_t t = tail.load(memory_order_relaxed);
+        for (size_t h = head.load(memory_order_relaxed); h != t; h = next(h))
+            a[h].~T();
+        allocator<T>().deallocate(a, capacity);
+    }
+
+    // producer side
+    bool try_push(const T &item)
+    {
+        size_t t = tail.load(memory_order_relaxed);
+        size_t n = next(t);
+        if (n == cachedHead)
+        {
+            cachedHead = head.load(memory_order_acquire);
+            if (n == cachedHead)
+                return false;
+        }
+        new (&a[t]) T(item);
+        tail.store(n, memory_order_release);
+        return true;
+    }
+
+    void add(const T &item)
+    {
+        if (!try_push(item))
+        {
+            throw QueueException("Queue is full");
+        }
+    }
+
+    // consumer side
+    bool try_pop(T &item)
+    {
+        size_t h = head.load(memory_order_relaxed);
+        if (h == cachedTail)
+        {
+            cachedTail = tail.load(memory_order_acquire);
+            if (h == cachedTail)
+                return false;
+        }
+        item = move(a[h]);
+        a[h].~T();
+        head.store(next(h), memory_order_release);
+        return true;
+    }
+
+    T *frontPtr()
+    {
+        size_t h = head.load(memory_order_relaxed);
+        if (h == cachedTail)
+        {
+            cachedTail = tail.load(memory_order_acquire);
+            if (h == cachedTail)
+                return nullptr;
+        }
+        return &a[h];
+    }
+
+    T frontValue()
+    {
+        T *p = frontPtr();
+        if (p == nullptr)
+        {
+            throw QueueException("Queue is empty");
+        }
+        return *p;
+    }
+
+    void remove()
+    {
+        if (frontPtr() == nullptr)
+        {
+            throw QueueException("Queue is empty");
+        }
+        size_t h = head.load(memory_order_relaxed);
+        a[h].~T();
+        head.store(next(h), memory_order_release);
+    }
+
+    // approximate when called while the other side is running
+    bool isEmpty() const
+    {
+        return head.load(memory_order_acquire) == tail.load(memory_order_acquire);
+    }
+
+    int getSize() const
+    {
+        size_t h = head.load(memory_order_acquire);
+        size_t t = tail.load(memory_order_acquire);
+        return (int)(t >= h ? t - h : t + capacity - h);
+    }
+
+    int getCapacity() const
+    {
+        return (int)(capacity - 1);
+    }
+};
+
+#endif
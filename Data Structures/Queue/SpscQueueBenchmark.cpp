@@ -0,0 +1,126 @@
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <cstdlib>
+#include "Queue.h"
+#include "SpscQueue.h"
+using namespace std;
+
+int items = 20000000;
+int roundTrips = 1000000;
+const int capacity = 1024;
+
+double seconds(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void spscThroughput()
+{
+    SpscQueue<int> q(capacity);
+    long long sum = 0;
+
+    auto start = chrono::steady_clock::now();
+    thread consumer([&]()
+                    {
+        int value;
+        for (int i = 0; i < items; i++)
+        {
+            while (!q.try_pop(value))
+                this_thread::yield();
+            sum += value;
+        } });
+    for (int i = 0; i < items; i++)
+    {
+        while (!q.try_push(i))
+            this_thread::yield();
+    }
+    consumer.join();
+    double t = seconds(start);
+
+    cout << "SpscQueue:       " << items / t / 1e6 << " M items/s (checksum " << sum << ")\n";
+}
+
+void mutexThroughput()
+{
+    Queue<int> q(capacity);
+    mutex m;
+    long long sum = 0;
+
+    auto start = chrono::steady_clock::now();
+    thread consumer([&]()
+                    {
+        for (int i = 0; i < items; i++)
+        {
+            while (true)
+            {
+                lock_guard<mutex> lock(m);
+                if (!q.isEmpty())
+                {
+                    sum += q.frontValue();
+                    q.remove();
+                    break;
+                }
+            }
+        } });
+    for (int i = 0; i < items; i++)
+    {
+        while (true)
+        {
+            lock_guard<mutex> lock(m);
+            if (!q.isFull())
+            {
+                q.add(i);
+                break;
+            }
+        }
+    }
+    consumer.join();
+    double t = seconds(start);
+
+    cout << "Queue + mutex:   " << items / t / 1e6 << " M items/s (checksum " << sum << ")\n";
+}
+
+void spscLatency()
+{
+    SpscQueue<int> ping(capacity);
+    SpscQueue<int> pong(capacity);
+
+    thread echo([&]()
+                {
+        int value;
+        for (int i = 0; i < roundTrips; i++)
+        {
+            while (!ping.try_pop(value))
+                this_thread::yield();
+            while (!pong.try_push(value))
+                this_thread::yield();
+        } });
+
+    auto start = chrono::steady_clock::now();
+    int value;
+    for (int i = 0; i < roundTrips; i++)
+    {
+        ping.try_push(i);
+        while (!pong.try_pop(value))
+            this_thread::yield();
+    }
+    double t = seconds(start);
+    echo.join();
+
+    cout << "SpscQueue round trip: " << t / roundTrips * 1e9 << " ns\n";
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+    {
+        items = atoi(argv[1]);
+        roundTrips = items / 20;
+    }
+    spscThroughput();
+    mutexThroughput();
+    spscLatency();
+    return 0;
+}
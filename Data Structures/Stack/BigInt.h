@@ -0,0 +1,562 @@
+#ifndef BIGINT_H
+#define BIGINT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "NumericEvaluator.h"
+
+// Arbitrary precision signed integer: a sign and a little-endian array of 32-bit
+// limbs with no leading zero limbs (zero has none and is never negative).
+//
+// Multiplication is schoolbook below karatsubaThreshold limbs and Karatsuba above,
+// which turns the O(n^2) of a million-digit product into about O(n^1.585).
+// Division is Knuth's algorithm D: one 64-by-32 bit estimate per quotient limb,
+// corrected at most twice, so O(n * m) instead of bit-at-a-time long division.
+// Division truncates toward zero and the remainder takes the dividend's sign, as
+// for built-in integers. Decimal conversion is quadratic, which is fine for
+// literals and printing but the slowest thing here at a million digits.
+class BigInt
+{
+public:
+    static const size_t karatsubaThreshold = 40;
+
+private:
+    typedef uint32_t Limb;
+    typedef uint64_t Wide;
+
+    bool negative;
+    vector<Limb> limbs;
+
+    void trim()
+    {
+        while (!limbs.empty() && limbs.back() == 0)
+            limbs.pop_back();
+        if (limbs.empty())
+            negative = false;
+    }
+
+    static int compareMagnitude(const vector<Limb> &a, const vector<Limb> &b)
+    {
+        if (a.size() != b.size())
+            return a.size() < b.size() ? -1 : 1;
+        for (size_t i = a.size(); i-- > 0;)
+        {
+            if (a[i] != b[i])
+                return a[i] < b[i] ? -1 : 1;
+        }
+        return 0;
+    }
+
+    static vector<Limb> addMagnitude(const vector<Limb> &a, const vector<Limb> &b)
+    {
+        const vector<Limb> &longer = a.size() >= b.size() ? a : b;
+        const vector<Limb> &shorter = a.size() >= b.size() ? b : a;
+        vector<Limb> sum(longer.size() + 1);
+        Wide carry = 0;
+        for (size_t i = 0; i < longer.size(); i++)
+        {
+            carry += (Wide)longer[i] + (i < shorter.size() ? shorter[i] : 0);
+            sum[i] = (Limb)carry;
+            carry >>= 32;
+        }
+        sum[longer.size()] = (Limb)carry;
+        return sum;
+    }
+
+    // a - b for |a| >= |b|
+    static vector<Limb> subtractMagnitude(const vector<Limb> &a, const vector<Limb> &b)
+    {
+        vector<Limb> difference(a.size());
+        Limb borrow = 0;
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            Wide d = (Wide)a[i] - (i < b.size() ? b[i] : 0) - borrow;
+            difference[i] = (Limb)d;
+            borrow = (Limb)(d >> 63);
+        }
+        return difference;
+    }
+
+    // out[0, len + carry) += x[0, len)
+    static void addInto(Limb *out, size_t outSize, const Limb *x, size_t len)
+    {
+        Wide carry = 0;
+        size_t i = 0;
+        for (; i < len; i++)
+        {
+            carry += (Wide)out[i] + x[i];
+            out[i] = (Limb)carry;
+            carry >>= 32;
+        }
+        for (; carry != 0 && i < outSize; i++)
+        {
+            carry += out[i];
+            out[i] = (Limb)carry;
+            carry >>= 32;
+        }
+    }
+
+    // x[0, n) -= y[0, m) for x >= y
+    static void subtractInto(Limb *x, size_t n, const Limb *y, size_t m)
+    {
+        Limb borrow = 0;
+        size_t i = 0;
+        for (; i < m; i++)
+        {
+            Wide d = (Wide)x[i] - y[i] - borrow;
+            x[i] = (Limb)d;
+            borrow = (Limb)(d >> 63);
+        }
+        for (; borrow != 0 && i < n; i++)
+        {
+            Wide d = (Wide)x[i] - borrow;
+            x[i] = (Limb)d;
+            borrow = (Limb)(d >> 63);
+        }
+    }
+
+    static size_t significant(const Limb *x, size_t n)
+    {
+        while (n > 0 && x[n - 1] == 0)
+            n--;
+        return n;
+    }
+
+    // out[0, n + m) = a * b; out must start zeroed
+    static void multiplySchoolbook(const Limb *a, size_t n, const Limb *b, size_t m, Limb *out)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            Wide carry = 0;
+            Wide ai = a[i];
+            if (ai == 0)
+                continue;
+            for (size_t j = 0; j < m; j++)
+            {
+                carry += ai * b[j] + out[i + j];
+                out[i + j] = (Limb)carry;
+                carry >>= 32;
+            }
+            out[i + m] = (Limb)carry;
+        }
+    }
+
+    // out[0, n + m) = a * b; out must start zeroed
+    static void multiplyKaratsuba(const Limb *a, size_t n, const Limb *b, size_t m, Limb *out)
+    {
+        if (n < m)
+        {
+            swap(a, b);
+            swap(n, m);
+        }
+        if (m < karatsubaThreshold)
+        {
+            multiplySchoolbook(a, n, b, m, out);
+            return;
+        }
+        if (2 * m <= n)
+        {
+            // lopsided: cut a into pieces the size of b
+            vector<Limb> piece(2 * m);
+            for (size_t i = 0; i < n; i += m)
+            {
+                size_t len = min(m, n - i);
+                fill(piece.begin(), piece.end(), 0);
+                multiplyKaratsuba(a + i, len, b, m, piece.data());
+                addInto(out + i, n + m - i, piece.data(), significant(piece.data(), len + m));
+            }
+            return;
+        }
+
+        // a = a1 B^h + a0, b = b1 B^h + b0 and
+        // a b = z2 B^2h + ((a0 + a1)(b0 + b1) - z0 - z2) B^h + z0
+        size_t h = n / 2;
+        size_t n1 = n - h, m1 = m - h;
+        vector<Limb> z0(2 * h, 0), z2(n1 + m1, 0);
+        multiplyKaratsuba(a, h, b, h, z0.data());
+        multiplyKaratsuba(a + h, n1, b + h, m1, z2.data());
+
+        vector<Limb> sa(n1 + 1, 0), sb(max(h, m1) + 1, 0);
+        copy(a + h, a + n, sa.begin());
+        addInto(sa.data(), sa.size(), a, h);
+        copy(b + h, b + m, sb.begin());
+        addInto(sb.data(), sb.size(), b, h);
+        size_t saLen = significant(sa.data(), sa.size()), sbLen = significant(sb.data(), sb.size());
+
+        vector<Limb> z1(saLen + sbLen + 1, 0);
+        multiplyKaratsuba(sa.data(), saLen, sb.data(), sbLen, z1.data());
+        subtractInto(z1.data(), z1.size(), z0.data(), significant(z0.data(), z0.size()));
+        subtractInto(z1.data(), z1.size(), z2.data(), significant(z2.data(), z2.size()));
+
+        size_t total = n + m;
+        addInto(out, total, z0.data(), significant(z0.data(), z0.size()));
+        addInto(out + h, total - h, z1.data(), significant(z1.data(), z1.size()));
+        addInto(out + 2 * h, total - 2 * h, z2.data(), significant(z2.data(), z2.size()));
+    }
+
+    // divides in place by a single limb and returns the remainder
+    static Limb divideSmall(vector<Limb> &a, Limb divisor)
+    {
+        Wide remainder = 0;
+        for (size_t i = a.size(); i-- > 0;)
+        {
+            Wide current = (remainder << 32) | a[i];
+            a[i] = (Limb)(current / divisor);
+            remainder = current % divisor;
+        }
+        return (Limb)remainder;
+    }
+
+    // Knuth, TAOCP vol. 2, 4.3.1, algorithm D; |a| >= |b| and b has two or more limbs
+    static void divideMagnitude(const vector<Limb> &a, const vector<Limb> &b, vector<Limb> &quotient, vector<Limb> &remainder)
+    {
+        size_t n = b.size(), m = a.size() - n;
+        int shift = __builtin_clz(b.back());
+
+        // normalize so the divisor's top limb has its high bit set
+        vector<Limb> v(n), u(a.size() + 1);
+        for (size_t i = n; i-- > 0;)
+            v[i] = (b[i] << shift) | (shift && i > 0 ? b[i - 1] >> (32 - shift) : 0);
+        u[a.size()] = shift ? a.back() >> (32 - shift) : 0;
+        for (size_t i = a.size(); i-- > 0;)
+            u[i] = (a[i] << shift) | (shift && i > 0 ? a[i - 1] >> (32 - shift) : 0);
+
+        quotient.assign(m + 1, 0);
+        Wide top = v[n - 1], second = v[n - 2];
+        for (size_t j = m + 1; j-- > 0;)
+        {
+            Wide numerator = ((Wide)u[j + n] << 32) | u[j + n - 1];
+            Wide qhat = numerator / top;
+            Wide rhat = numerator % top;
+            while (qhat >> 32 || qhat * second > ((rhat << 32) | u[j + n - 2]))
+            {
+                qhat--;
+                rhat += top;
+                if (rhat >> 32)
+                    break;
+            }
+
+            // u[j, j + n] -= qhat * v
+            int64_t borrow = 0;
+            Wide carry = 0;
+            for (size_t i = 0; i < n; i++)
+            {
+                Wide product = qhat * v[i] + carry;
+                carry = product >> 32;
+                int64_t t = (int64_t)u[i + j] - (int64_t)(Limb)product + borrow;
+                u[i + j] = (Limb)t;
+                borrow = t >> 32;
+            }
+            int64_t t = (int64_t)u[j + n] - (int64_t)carry + borrow;
+            u[j + n] = (Limb)t;
+
+            if (t < 0)
+            {
+                // qhat was one too large: add v back
+                qhat--;
+                Wide c = 0;
+                for (size_t i = 0; i < n; i++)
+                {
+                    c += (Wide)u[i + j] + v[i];
+                    u[i + j] = (Limb)c;
+                    c >>= 32;
+                }
+                u[j + n] += (Limb)c;
+            }
+            quotient[j] = (Limb)qhat;
+        }
+
+        remainder.assign(n, 0);
+        for (size_t i = 0; i < n; i++)
+            remainder[i] = (u[i] >> shift) | (shift ? (Limb)((Wide)u[i + 1] << (32 - shift)) : 0);
+    }
+
+    static BigInt fromMagnitude(vector<Limb> &&magnitude, bool negative)
+    {
+        BigInt r;
+        r.limbs = move(magnitude);
+        r.negative = negative;
+        r.trim();
+        return r;
+    }
+
+public:
+    BigInt(long long value = 0) : negative(value < 0)
+    {
+        unsigned long long magnitude = negative ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+        while (magnitude != 0)
+        {
+            limbs.push_back((Limb)magnitude);
+            magnitude >>= 32;
+        }
+    }
+
+    // from raw little-endian 32-bit limbs
+    static BigInt fromLimbs(const vector<uint32_t> &magnitude, bool negative = false)
+    {
+        vector<Limb> copy(magnitude);
+        return fromMagnitude(move(copy), negative);
+    }
+
+    // decimal digits with an optional leading '-'
+    explicit BigInt(const string &text) : negative(false)
+    {
+        size_t i = 0;
+        bool minus = false;
+        if (i < text.size() && (text[i] == '-' || text[i] == '+'))
+            minus = text[i++] == '-';
+        if (i == text.size())
+            throw runtime_error("Invalid integer: " + text);
+        // nine digits at a time: limbs = limbs * 10^9 + chunk
+        size_t first = (text.size() - i) % 9;
+        if (first == 0)
+            first = 9;
+        while (i < text.size())
+        {
+            Limb chunk = 0;
+            for (size_t k = 0; k < first; k++, i++)
+            {
+                if (text[i] < '0' || text[i] > '9')
+                    throw runtime_error("Invalid integer: " + text);
+                chunk = chunk * 10 + (Limb)(text[i] - '0');
+            }
+            Wide carry = chunk;
+            for (Limb &limb : limbs)
+            {
+                carry += (Wide)limb * 1000000000u;
+                limb = (Limb)carry;
+                carry >>= 32;
+            }
+            if (carry != 0)
+                limbs.push_back((Limb)carry);
+            first = 9;
+        }
+        negative = minus;
+        trim();
+    }
+
+    string toString() const
+    {
+        if (limbs.empty())
+            return "0";
+        vector<Limb> rest = limbs;
+        vector<Limb> chunks; // base 10^9, least significant first
+        while (!rest.empty())
+        {
+            chunks.push_back(divideSmall(rest, 1000000000u));
+            while (!rest.empty() && rest.back() == 0)
+                rest.pop_back();
+        }
+        string text = negative ? "-" : "";
+        text += to_string(chunks.back());
+        for (size_t i = chunks.size() - 1; i-- > 0;)
+        {
+            string part = to_string(chunks[i]);
+            text.append(9 - part.size(), '0');
+            text += part;
+        }
+        return text;
+    }
+
+    bool isZero() const
+    {
+        return limbs.empty();
+    }
+
+    bool isNegative() const
+    {
+        return negative;
+    }
+
+    bool isOdd() const
+    {
+        return !limbs.empty() && (limbs[0] & 1);
+    }
+
+    size_t limbCount() const
+    {
+        return limbs.size();
+    }
+
+    size_t bitLength() const
+    {
+        return limbs.empty() ? 0 : limbs.size() * 32 - __builtin_clz(limbs.back());
+    }
+
+    // true and the value in out if it fits in a long long
+    bool toLongLong(long long &out) const
+    {
+        if (limbs.size() > 2)
+            return false;
+        unsigned long long magnitude = 0;
+        for (size_t i = limbs.size(); i-- > 0;)
+            magnitude = (magnitude << 32) | limbs[i];
+        if (negative ? magnitude > (1ULL << 63) : magnitude >= (1ULL << 63))
+            return false;
+        out = negative ? (long long)(0ULL - magnitude) : (long long)magnitude;
+        return true;
+    }
+
+    static int compare(const BigInt &a, const BigInt &b)
+    {
+        if (a.negative != b.negative)
+            return a.negative ? -1 : 1;
+        int c = compareMagnitude(a.limbs, b.limbs);
+        return a.negative ? -c : c;
+    }
+
+    BigInt operator-() const
+    {
+        BigInt r = *this;
+        if (!r.limbs.empty())
+            r.negative = !r.negative;
+        return r;
+    }
+
+    friend BigInt operator+(const BigInt &a, const BigInt &b)
+    {
+        if (a.negative == b.negative)
+            return fromMagnitude(addMagnitude(a.limbs, b.limbs), a.negative);
+        if (compareMagnitude(a.limbs, b.limbs) >= 0)
+            return fromMagnitude(subtractMagnitude(a.limbs, b.limbs), a.negative);
+        return fromMagnitude(subtractMagnitude(b.limbs, a.limbs), b.negative);
+    }
+
+    friend BigInt operator-(const BigInt &a, const BigInt &b)
+    {
+        return a + (-b);
+    }
+
+    // karatsuba = false forces the schoolbook algorithm (for comparison)
+    static BigInt multiply(const BigInt &a, const BigInt &b, bool karatsuba = true)
+    {
+        if (a.limbs.empty() || b.limbs.empty())
+            return BigInt();
+        vector<Limb> product(a.limbs.size() + b.limbs.size(), 0);
+        if (karatsuba)
+            multiplyKaratsuba(a.limbs.data(), a.limbs.size(), b.limbs.data(), b.limbs.size(), product.data());
+        else
+            multiplySchoolbook(a.limbs.data(), a.limbs.size(), b.limbs.data(), b.limbs.size(), product.data());
+        return fromMagnitude(move(product), a.negative != b.negative);
+    }
+
+    friend BigInt operator*(const BigInt &a, const BigInt &b)
+    {
+        return multiply(a, b);
+    }
+
+    // quotient truncated toward zero; the remainder has the dividend's sign
+    static void divide(const BigInt &a, const BigInt &b, BigInt &quotient, BigInt &remainder)
+    {
+        if (b.limbs.empty())
+            throw runtime_error("Division by zero");
+        if (compareMagnitude(a.limbs, b.limbs) < 0)
+        {
+            remainder = a;
+            quotient = BigInt();
+            return;
+        }
+        vector<Limb> q, r;
+        if (b.limbs.size() == 1)
+        {
+            q = a.limbs;
+            Limb rest = divideSmall(q, b.limbs[0]);
+            if (rest != 0)
+                r.push_back(rest);
+        }
+        else
+            divideMagnitude(a.limbs, b.limbs, q, r);
+        bool aNegative = a.negative, quotientNegative = a.negative != b.negative;
+        quotient = fromMagnitude(move(q), quotientNegative);
+        remainder = fromMagnitude(move(r), aNegative);
+    }
+
+    friend BigInt operator/(const BigInt &a, const BigInt &b)
+    {
+        BigInt q, r;
+        divide(a, b, q, r);
+        return q;
+    }
+
+    friend BigInt operator%(const BigInt &a, const BigInt &b)
+    {
+        BigInt q, r;
+        divide(a, b, q, r);
+        return r;
+    }
+
+    // exponentiation by squaring
+    static BigInt power(BigInt base, unsigned long long exponent)
+    {
+        BigInt result(1);
+        while (exponent != 0)
+        {
+            if (exponent & 1)
+                result = result * base;
+            exponent >>= 1;
+            if (exponent != 0)
+                base = base * base;
+        }
+        return result;
+    }
+
+    BigInt &operator+=(const BigInt &b) { return *this = *this + b; }
+    BigInt &operator-=(const BigInt &b) { return *this = *this - b; }
+    BigInt &operator*=(const BigInt &b) { return *this = *this * b; }
+    BigInt &operator/=(const BigInt &b) { return *this = *this / b; }
+
+    friend bool operator==(const BigInt &a, const BigInt &b) { return a.negative == b.negative && a.limbs == b.limbs; }
+    friend bool operator!=(const BigInt &a, const BigInt &b) { return !(a == b); }
+    friend bool operator<(const BigInt &a, const BigInt &b) { return compare(a, b) < 0; }
+    friend bool operator>(const BigInt &a, const BigInt &b) { return compare(a, b) > 0; }
+    friend bool operator<=(const BigInt &a, const BigInt &b) { return compare(a, b) <= 0; }
+    friend bool operator>=(const BigInt &a, const BigInt &b) { return compare(a, b) >= 0; }
+
+    friend ostream &operator<<(ostream &out, const BigInt &value)
+    {
+        return out << value.toString();
+    }
+};
+
+// exact integers of any size; / and ^ follow the checked int64 rules
+template <>
+struct NumberTraits<BigInt>
+{
+    static BigInt fromLiteral(const string &text)
+    {
+        return BigInt(text);
+    }
+
+    static BigInt add(const BigInt &a, const BigInt &b) { return a + b; }
+    static BigInt subtract(const BigInt &a, const BigInt &b) { return a - b; }
+    static BigInt multiply(const BigInt &a, const BigInt &b) { return a * b; }
+    static BigInt divide(const BigInt &a, const BigInt &b) { return a / b; }
+    static BigInt negate(const BigInt &a) { return -a; }
+
+    static BigInt power(const BigInt &a, const BigInt &b)
+    {
+        if (b.isNegative())
+            return NumberTraits<long long>::negativePower(a == BigInt(1), a == BigInt(-1), a.isZero(), b.isOdd());
+        long long exponent;
+        if (!b.toLongLong(exponent))
+        {
+            // only 0, 1 and -1 survive an exponent that large
+            if (a.isZero() || a == BigInt(1))
+                return a;
+            if (a == BigInt(-1))
+                return b.isOdd() ? a : BigInt(1);
+            throw runtime_error("Exponent too large");
+        }
+        return BigInt::power(a, (unsigned long long)exponent);
+    }
+
+    static string toString(const BigInt &a)
+    {
+        return a.toString();
+    }
+};
+
+#endif
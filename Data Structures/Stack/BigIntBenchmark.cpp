@@ -0,0 +1,123 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include "BigInt.h"
+using namespace std;
+
+double seconds(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// a random number with about `digits` decimal digits
+BigInt randomNumber(mt19937 &rng, size_t digits)
+{
+    vector<uint32_t> limbs(digits * 100 / 963 + 1);
+    for (uint32_t &limb : limbs)
+        limb = (uint32_t)rng();
+    limbs.back() |= 1u << 31;
+    return BigInt::fromLimbs(limbs);
+}
+
+size_t decimalDigits(const BigInt &x)
+{
+    return (size_t)(x.bitLength() * 0.30103) + 1;
+}
+
+// runs f often enough to measure and returns seconds per call
+template <typename F>
+double timePerCall(F f)
+{
+    int calls = 0;
+    auto start = chrono::steady_clock::now();
+    do
+    {
+        f();
+        calls++;
+    } while (seconds(start) < 0.2);
+    return seconds(start) / calls;
+}
+
+int main(int argc, char **argv)
+{
+    size_t maxDigits = argc > 1 ? (size_t)atoll(argv[1]) : 1000000;
+    size_t maxSchoolbook = argc > 2 ? (size_t)atoll(argv[2]) : 100000;
+    mt19937 rng(3);
+
+    cout << "multiply (n x n digits)" << endl;
+    for (size_t digits = 1000; digits <= maxDigits; digits *= 10)
+    {
+        BigInt a = randomNumber(rng, digits), b = randomNumber(rng, digits);
+        BigInt product;
+        double karatsuba = timePerCall([&]
+                                       { product = a * b; });
+        cout << "  " << digits << " digits: Karatsuba " << karatsuba * 1e3 << " ms";
+        if (digits <= maxSchoolbook)
+        {
+            BigInt check;
+            double schoolbook = timePerCall([&]
+                                            { check = BigInt::multiply(a, b, false); });
+            cout << ", schoolbook " << schoolbook * 1e3 << " ms" << (check == product ? "" : "  MISMATCH");
+        }
+        cout << endl;
+    }
+
+    cout << "divide (2n by n digits)" << endl;
+    for (size_t digits = 1000; digits <= min(maxDigits, (size_t)100000); digits *= 10)
+    {
+        BigInt a = randomNumber(rng, digits), b = randomNumber(rng, digits);
+        BigInt n = a * b + BigInt(12345), q, r;
+        double divide = timePerCall([&]
+                                    { BigInt::divide(n, b, q, r); });
+        cout << "  " << digits << " digits: " << divide * 1e3 << " ms"
+             << (q == a && r == BigInt(12345) ? "" : "  MISMATCH") << endl;
+    }
+
+    cout << "power 3 ^ k (exponentiation by squaring)" << endl;
+    for (size_t digits = 1000; digits <= maxDigits; digits *= 10)
+    {
+        unsigned long long k = (unsigned long long)(digits / 0.47712);
+        BigInt x;
+        double power = timePerCall([&]
+                                   { x = BigInt::power(BigInt(3), k); });
+        cout << "  3 ^ " << k << " (" << decimalDigits(x) << " digits): " << power * 1e3 << " ms" << endl;
+    }
+
+    // one evaluator, three number types
+    cout << "x * x - 3 * x + 7 ^ 2, evaluated per mode" << endl;
+    Expression e = Expression::compile("x * x - 3 * x + 7 ^ 2");
+    int evaluations = 1000000;
+    {
+        NumericEvaluator<long long> checked(e);
+        long long sum = 0;
+        auto start = chrono::steady_clock::now();
+        for (long long x = 0; x < evaluations; x++)
+            sum += checked.evaluate(&x);
+        cout << "  int64 (checked): " << evaluations / seconds(start) / 1e6 << " M evals/s  (" << sum << ")" << endl;
+    }
+    {
+        NumericEvaluator<double> floating(e);
+        double sum = 0;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < evaluations; i++)
+        {
+            double x = i;
+            sum += floating.evaluate(&x);
+        }
+        cout << "  double:          " << evaluations / seconds(start) / 1e6 << " M evals/s  (" << sum << ")" << endl;
+    }
+    {
+        NumericEvaluator<BigInt> exact(e);
+        BigInt sum;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < evaluations / 10; i++)
+        {
+            BigInt x(i);
+            sum += exact.evaluate(&x);
+        }
+        cout << "  BigInt:          " << evaluations / 10 / seconds(start) / 1e6 << " M evals/s  (" << sum << ")" << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,284 @@
+#ifndef COLUMNEVALUATOR_H
+#define COLUMNEVALUATOR_H
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "Expression.h"
+
+// Evaluates a compiled Expression over whole columns of rows at a time.
+// Instead of a stack of scalars it keeps a stack of column buffers: the bytecode is
+// walked once per block of blockRows rows and every instruction becomes one tight
+// loop over the block, which the compiler can vectorize for + - * and (for floating
+// point) /. Variables are read straight from the caller's columns and constants stay
+// scalars, so neither is ever copied into a buffer.
+//
+// T may be a floating point or an integer type. Integer + - * wrap around instead of
+// overflowing, and constants are converted with static_cast (2.5 becomes 2).
+// Division by zero is defined per row: integers give 0, floating point gives the
+// IEEE inf or nan, and in both cases that row's error flag is set. INT_MIN / -1
+// wraps to INT_MIN.
+template <typename T>
+class ColumnEvaluator
+{
+public:
+    static const int blockRows = 1024;
+
+private:
+    typedef typename conditional<is_integral<T>::value, make_unsigned<T>, enable_if<true, T>>::type::type Wide;
+
+    struct Entry
+    {
+        const T *column; // null for a scalar
+        T scalar;
+    };
+
+    vector<Expression::Instruction> code;
+    vector<T> constants;
+    int variableCount;
+    int maxDepth;
+    vector<T> buffers;       // maxDepth blocks of blockRows
+    vector<Entry> stack;     // maxDepth entries
+    vector<T> savedBuffers;  // one block per temporary
+    vector<Entry> saved;     // the temporaries, pointing into savedBuffers or scalar
+    vector<uint8_t> zeroes;  // per row of the current block: divided by zero
+
+public:
+    // scalar semantics of each operator, also used by ExpressionOptimizer to fold constants
+    struct AddOp
+    {
+        T operator()(T a, T b) const { return (T)((Wide)a + (Wide)b); }
+    };
+
+    struct SubOp
+    {
+        T operator()(T a, T b) const { return (T)((Wide)a - (Wide)b); }
+    };
+
+    struct MulOp
+    {
+        T operator()(T a, T b) const { return (T)((Wide)a * (Wide)b); }
+    };
+
+    struct DivOp
+    {
+        T operator()(T a, T b) const
+        {
+            if constexpr (is_integral<T>::value)
+            {
+                // branch free so the loop stays a straight line
+                bool zero = b == 0;
+                bool overflow = is_signed<T>::value && a == numeric_limits<T>::min() && b == (T)-1;
+                T divisor = (zero || overflow) ? (T)1 : b;
+                T quotient = a / divisor;
+                quotient = overflow ? a : quotient;
+                return zero ? (T)0 : quotient;
+            }
+            else
+                return a / b;
+        }
+    };
+
+    struct PowOp
+    {
+        T operator()(T a, T b) const
+        {
+            if constexpr (is_integral<T>::value)
+                return integerPower(a, b);
+            else
+                return (T)Expression::power((double)a, (double)b);
+        }
+    };
+
+    // wraps like the other integer operators; negative exponents truncate toward zero
+    static T integerPower(T a, T b)
+    {
+        if (b < 0)
+        {
+            if (a == 1)
+                return 1;
+            if (a == (T)-1)
+                return (b & 1) ? (T)-1 : (T)1;
+            return 0;
+        }
+        Wide result = 1, base = (Wide)a;
+        for (Wide k = (Wide)b; k != 0; k >>= 1)
+        {
+            if (k & 1)
+                result *= base;
+            base *= base;
+        }
+        return (T)result;
+    }
+
+private:
+    // a = a op b, writing into out when either side is a column
+    template <typename Op>
+    static void apply(Entry &a, const Entry &b, T *out, int n, Op op)
+    {
+        if (a.column == nullptr && b.column == nullptr)
+        {
+            a.scalar = op(a.scalar, b.scalar);
+            return;
+        }
+        if (a.column == nullptr)
+        {
+            T x = a.scalar;
+            const T *y = b.column;
+            for (int i = 0; i < n; i++)
+                out[i] = op(x, y[i]);
+        }
+        else if (b.column == nullptr)
+        {
+            const T *x = a.column;
+            T y = b.scalar;
+            for (int i = 0; i < n; i++)
+                out[i] = op(x[i], y);
+        }
+        else
+        {
+            const T *x = a.column;
+            const T *y = b.column;
+            for (int i = 0; i < n; i++)
+                out[i] = op(x[i], y[i]);
+        }
+        a.column = out;
+    }
+
+    // flags the rows whose divisor is zero
+    void markZeroes(const Entry &divisor, int n)
+    {
+        if (divisor.column == nullptr)
+        {
+            if (divisor.scalar == 0)
+            {
+                for (int i = 0; i < n; i++)
+                    zeroes[i] = 1;
+            }
+            return;
+        }
+        const T *d = divisor.column;
+        uint8_t *z = zeroes.data();
+        for (int i = 0; i < n; i++)
+            z[i] |= (uint8_t)(d[i] == 0);
+    }
+
+    // runs the program over rows [first, first + n) with n <= blockRows
+    void evaluateBlock(const T *const *columns, int first, int n, T *results, uint8_t *errors)
+    {
+        int top = -1;
+        Entry *s = stack.data();
+        bool divides = false;
+        for (const Expression::Instruction &in : code)
+        {
+            // a result always lands in the buffer of the stack level it ends up on
+            T *out = buffers.data() + (size_t)(top > 0 ? top - 1 : 0) * blockRows;
+            switch (in.op)
+            {
+            case Expression::Constant:
+                s[++top] = Entry{nullptr, constants[in.operand]};
+                break;
+            case Expression::Variable:
+                s[++top] = Entry{columns[in.operand] + first, T()};
+                break;
+            case Expression::Add:
+                apply(s[top - 1], s[top], out, n, AddOp());
+                top--;
+                break;
+            case Expression::Sub:
+                apply(s[top - 1], s[top], out, n, SubOp());
+                top--;
+                break;
+            case Expression::Mul:
+                apply(s[top - 1], s[top], out, n, MulOp());
+                top--;
+                break;
+            case Expression::Div:
+                if (!divides)
+                {
+                    fill(zeroes.begin(), zeroes.begin() + n, (uint8_t)0);
+                    divides = true;
+                }
+                markZeroes(s[top], n);
+                apply(s[top - 1], s[top], out, n, DivOp());
+                top--;
+                break;
+            case Expression::Pow:
+                apply(s[top - 1], s[top], out, n, PowOp());
+                top--;
+                break;
+            case Expression::Neg:
+                out = buffers.data() + (size_t)top * blockRows;
+                apply(s[top], Entry{nullptr, (T)-1}, out, n, MulOp());
+                break;
+            case Expression::Save:
+                // the level buffer will be reused, so the rows are copied out
+                if (s[top].column == nullptr)
+                    saved[in.operand] = s[top];
+                else
+                {
+                    T *keep = savedBuffers.data() + (size_t)in.operand * blockRows;
+                    copy(s[top].column, s[top].column + n, keep);
+                    saved[in.operand] = Entry{keep, T()};
+                }
+                break;
+            case Expression::Load:
+                s[++top] = saved[in.operand];
+                break;
+            }
+        }
+
+        if (s[0].column == nullptr)
+            fill(results + first, results + first + n, s[0].scalar);
+        else
+            copy(s[0].column, s[0].column + n, results + first);
+        if (errors != nullptr)
+        {
+            if (divides)
+                copy(zeroes.begin(), zeroes.begin() + n, errors + first);
+            else
+                fill(errors + first, errors + first + n, (uint8_t)0);
+        }
+    }
+
+public:
+    ColumnEvaluator(const Expression &e)
+        : code(e.getCode()), variableCount((int)e.getVariables().size()), maxDepth(e.getMaxDepth())
+    {
+        for (double c : e.getConstants())
+            constants.push_back(static_cast<T>(c));
+        buffers.assign((size_t)maxDepth * blockRows, T());
+        stack.resize(maxDepth);
+        savedBuffers.assign((size_t)e.getTemporaries() * blockRows, T());
+        saved.resize(e.getTemporaries());
+        zeroes.assign(blockRows, 0);
+    }
+
+    int getVariableCount() const
+    {
+        return variableCount;
+    }
+
+    // columns[v] holds `rows` values of the expression's variable v. Writes one result
+    // per row; errors, if given, gets 1 for rows that divided by zero and 0 elsewhere.
+    // Not thread safe: the buffers belong to the evaluator.
+    void evaluate(const T *const *columns, int rows, T *results, uint8_t *errors = nullptr)
+    {
+        for (int first = 0; first < rows; first += blockRows)
+        {
+            int n = rows - first < blockRows ? rows - first : blockRows;
+            evaluateBlock(columns, first, n, results, errors);
+        }
+    }
+
+    void evaluate(const vector<const T *> &columns, int rows, T *results, uint8_t *errors = nullptr)
+    {
+        if ((int)columns.size() < variableCount)
+            throw runtime_error("Missing variable columns");
+        evaluate(columns.data(), rows, results, errors);
+    }
+};
+
+#endif
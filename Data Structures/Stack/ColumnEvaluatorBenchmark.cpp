@@ -0,0 +1,93 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include "ColumnEvaluator.h"
+using namespace std;
+
+double seconds(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// the formula below, written out by hand; the target to get close to
+template <typename T>
+void handWritten(const T *a, const T *b, const T *c, int rows, T *out)
+{
+    for (int i = 0; i < rows; i++)
+        out[i] = (a[i] + b[i]) * (a[i] - b[i]) + c[i] * 3 - a[i] * c[i];
+}
+
+template <typename T>
+void run(const char *label, int rows, int repeats)
+{
+    const char *formula = "(a + b) * (a - b) + c * 3 - a * c";
+    vector<T> a(rows), b(rows), c(rows), expected(rows), results(rows);
+    for (int i = 0; i < rows; i++)
+    {
+        a[i] = (T)(i % 1000);
+        b[i] = (T)((i * 7) % 300);
+        c[i] = (T)((i * 13) % 50);
+    }
+
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+    {
+        handWritten(a.data(), b.data(), c.data(), rows, expected.data());
+        // keeps the compiler from running the identical repeats only once
+        asm volatile("" : : "r"(expected.data()) : "memory");
+    }
+    double hand = seconds(start);
+
+    Expression e = Expression::compile(formula);
+    ColumnEvaluator<T> columns(e);
+    vector<const T *> inputs{a.data(), b.data(), c.data()};
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+        columns.evaluate(inputs, rows, results.data());
+    double batch = seconds(start);
+    bool ok = results == expected;
+
+    // one row at a time through the scalar bytecode VM
+    int scalarRows = rows / 4;
+    double values[3];
+    double sum = 0;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < scalarRows; i++)
+    {
+        values[0] = (double)a[i];
+        values[1] = (double)b[i];
+        values[2] = (double)c[i];
+        sum += e.evaluate(values);
+    }
+    double scalar = seconds(start) / scalarRows * rows;
+
+    double total = (double)rows * repeats;
+    cout << label << ": hand-written " << total / hand / 1e6 << " M rows/s, column-at-a-time "
+         << total / batch / 1e6 << " M rows/s, row-at-a-time VM " << rows / scalar / 1e6 << " M rows/s"
+         << (ok ? "" : "  MISMATCH") << "  (checksum " << sum << ")" << endl;
+}
+
+int main(int argc, char **argv)
+{
+    int rows = argc > 1 ? atoi(argv[1]) : 1000000;
+    int repeats = argc > 2 ? atoi(argv[2]) : 20;
+
+    run<double>("double ", rows, repeats);
+    run<long long>("int64  ", rows, repeats);
+    run<int>("int32  ", rows, repeats);
+
+    // division: a zero divisor only affects its own row
+    const int n = 8;
+    int x[n] = {10, 20, 30, 40, 50, 60, 70, 80};
+    int y[n] = {2, 0, 3, 0, 5, -1, 7, 0};
+    int q[n];
+    uint8_t errors[n];
+    ColumnEvaluator<int> division(Expression::compile("x / y + 1"));
+    division.evaluate(vector<const int *>{x, y}, n, q, errors);
+    cout << "x / y + 1:";
+    for (int i = 0; i < n; i++)
+        cout << ' ' << q[i] << (errors[i] ? "!" : "");
+    cout << "   (! = divided by zero)" << endl;
+    return 0;
+}
@@ -0,0 +1,191 @@
+#ifndef CONCURRENTSTACK_H
+#define CONCURRENTSTACK_H
+
+#include <atomic>
+#include <thread>
+#include <utility>
+#include "HazardPointers.h"
+#include "StackException.h"
+
+// Lock-free Treiber stack: push and pop swing the head pointer with a CAS.
+// Popped nodes are retired through HazardPointers, so a node cannot be freed, or
+// reused at the same address (the ABA case), while another thread still reads it.
+//
+// With elimination = true a push and a pop that both lose the CAS on head can
+// meet in a small side array and hand the value over without touching head at
+// all, which keeps heavy push/pop mixes from all hammering one cache line.
+template <typename T, bool elimination = false>
+class ConcurrentStack
+{
+private:
+    struct Node
+    {
+        T value;
+        Node *next;
+
+        template <typename... Args>
+        Node(Args &&...args) : value(forward<Args>(args)...), next(nullptr) {}
+    };
+
+    static const size_t cacheLine = 64;
+    static const int eliminationSlots = 16;
+    static const int eliminationWait = 64;
+
+    // each exchanger slot gets its own cache line, apart from head, so that exchanges
+    // do not invalidate the line every push and pop CASes
+    struct alignas(cacheLine) Slot
+    {
+        atomic<Node *> node;
+    };
+
+    alignas(cacheLine) atomic<Node *> head;
+    Slot exchanger[elimination ? eliminationSlots : 1];
+
+    // marks a slot whose offer was taken; only the offering push clears it
+    static Node *taken()
+    {
+        return reinterpret_cast<Node *>(1);
+    }
+
+    static unsigned int randomSlot()
+    {
+        thread_local unsigned int seed = (unsigned int)hash<thread::id>()(this_thread::get_id());
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 16) % eliminationSlots;
+    }
+
+    // a push that lost the race offers its node; true if a pop took it
+    bool offer(Node *node)
+    {
+        atomic<Node *> &slot = exchanger[randomSlot()].node;
+        Node *expected = nullptr;
+        if (!slot.compare_exchange_strong(expected, node, memory_order_release, memory_order_relaxed))
+            return false;
+        for (int i = 0; i < eliminationWait; i++)
+        {
+            if (slot.load(memory_order_relaxed) == taken())
+                break;
+        }
+        expected = node;
+        if (slot.compare_exchange_strong(expected, nullptr, memory_order_relaxed))
+            return false;
+        // a pop marked the slot; the node is no longer ours
+        slot.store(nullptr, memory_order_release);
+        return true;
+    }
+
+    // a pop that lost the race looks for a waiting push
+    Node *accept()
+    {
+        atomic<Node *> &slot = exchanger[randomSlot()].node;
+        Node *node = slot.load(memory_order_acquire);
+        if (node == nullptr || node == taken())
+            return nullptr;
+        if (!slot.compare_exchange_strong(node, taken(), memory_order_acquire, memory_order_relaxed))
+            return nullptr;
+        return node;
+    }
+
+    void pushNode(Node *node)
+    {
+        node->next = head.load(memory_order_relaxed);
+        while (!head.compare_exchange_weak(node->next, node, memory_order_release, memory_order_relaxed))
+        {
+            if (elimination && offer(node))
+                return;
+            node->next = head.load(memory_order_relaxed);
+        }
+    }
+
+public:
+    ConcurrentStack()
+    {
+        head.store(nullptr, memory_order_relaxed);
+        for (Slot &slot : exchanger)
+            slot.node.store(nullptr, memory_order_relaxed);
+    }
+
+    ConcurrentStack(const ConcurrentStack &) = delete;
+    ConcurrentStack &operator=(const ConcurrentStack &) = delete;
+
+    // must not race with other operations
+    ~ConcurrentStack()
+    {
+        Node *node = head.load(memory_order_relaxed);
+        while (node != nullptr)
+        {
+            Node *next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+
+    template <typename... Args>
+    void emplace(Args &&...args)
+    {
+        pushNode(new Node(forward<Args>(args)...));
+    }
+
+    void push(const T &value)
+    {
+        emplace(value);
+    }
+
+    void push(T &&value)
+    {
+        emplace(move(value));
+    }
+
+    bool try_pop(T &out)
+    {
+        while (true)
+        {
+            Node *node = HazardPointers::protect(head);
+            if (node == nullptr)
+            {
+                HazardPointers::clear();
+                return false;
+            }
+            // node is protected, so reading next is safe even if it was popped meanwhile
+            Node *next = node->next;
+            if (head.compare_exchange_strong(node, next, memory_order_acquire, memory_order_relaxed))
+            {
+                HazardPointers::clear();
+                out = move(node->value);
+                HazardPointers::retire(node);
+                return true;
+            }
+            HazardPointers::clear();
+
+            if (elimination)
+            {
+                Node *given = accept();
+                if (given != nullptr)
+                {
+                    // never reachable from head, so nobody else can hold a pointer to it
+                    out = move(given->value);
+                    delete given;
+                    return true;
+                }
+            }
+        }
+    }
+
+    T pop()
+    {
+        T value;
+        if (!try_pop(value))
+        {
+            throw StackException("Stack is empty");
+        }
+        return value;
+    }
+
+    // a snapshot; another thread may change it right after
+    bool isEmpty() const
+    {
+        return head.load(memory_order_acquire) == nullptr;
+    }
+};
+
+#endif
@@ -0,0 +1,99 @@
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include "Stack.h"
+#include "ConcurrentStack.h"
+using namespace std;
+
+int opsPerThread = 1000000;
+
+// Stack<T> behind one mutex, the setup ConcurrentStack replaces
+struct LockedStack
+{
+    Stack<int> s;
+    mutex m;
+
+    LockedStack() : s(1 << 24) {}
+
+    void push(int v)
+    {
+        lock_guard<mutex> lock(m);
+        s.push(v);
+    }
+
+    bool try_pop(int &v)
+    {
+        lock_guard<mutex> lock(m);
+        return s.try_pop(v);
+    }
+};
+
+// Every thread pushes its own range of ids and pops roughly as often as it pushes.
+// Afterwards the stack is drained and every id must have been popped exactly once.
+template <typename S>
+void run(const char *name, int threads)
+{
+    S stack;
+    int total = opsPerThread * threads;
+    vector<atomic<unsigned char>> seen(total);
+    for (auto &s : seen)
+        s.store(0, memory_order_relaxed);
+    atomic<long long> popped(0);
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> pool;
+    for (int t = 0; t < threads; t++)
+    {
+        pool.emplace_back([&, t]()
+                          {
+            int value;
+            long long count = 0;
+            for (int i = 0; i < opsPerThread; i++)
+            {
+                stack.push(t * opsPerThread + i);
+                if (stack.try_pop(value))
+                {
+                    seen[value].fetch_add(1, memory_order_relaxed);
+                    count++;
+                }
+            }
+            popped.fetch_add(count); });
+    }
+    for (thread &t : pool)
+        t.join();
+    double time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    int value;
+    while (stack.try_pop(value))
+        seen[value].fetch_add(1, memory_order_relaxed);
+    bool ok = true;
+    for (auto &s : seen)
+        ok = ok && s.load() == 1;
+
+    cout << "  " << name << ": " << 2.0 * total / time / 1e6 << " M ops/s"
+         << (ok ? "" : "  LOST OR DUPLICATED VALUES") << '\n';
+}
+
+int main(int argc, char *argv[])
+{
+    int maxThreads = thread::hardware_concurrency();
+    if (argc > 1)
+        maxThreads = atoi(argv[1]);
+    if (argc > 2)
+        opsPerThread = atoi(argv[2]);
+    if (maxThreads < 1)
+        maxThreads = 1;
+
+    for (int n = 1; n <= maxThreads; n *= 2)
+    {
+        cout << n << " thread(s):\n";
+        run<LockedStack>("Stack + mutex          ", n);
+        run<ConcurrentStack<int>>("ConcurrentStack        ", n);
+        run<ConcurrentStack<int, true>>("ConcurrentStack + elim.", n);
+    }
+    return 0;
+}
@@ -0,0 +1,45 @@
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include "ExpressionFile.h"
+using namespace std;
+
+// Evaluates every line of a file of arithmetic expressions, in parallel.
+// usage: EvaluateExpressions <input> [output] [threads]
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        cerr << "usage: " << argv[0] << " <input> [output] [threads]" << endl;
+        return 2;
+    }
+    int threads = argc > 3 ? atoi(argv[3]) : 0;
+
+    try
+    {
+        ExpressionFile::Stats stats;
+        if (argc > 2 && string(argv[2]) != "-")
+        {
+            ofstream out(argv[2], ios::binary);
+            if (!out)
+            {
+                cerr << "Cannot open " << argv[2] << endl;
+                return 1;
+            }
+            stats = ExpressionFile::evaluateFile(argv[1], out, threads);
+        }
+        else
+        {
+            ios::sync_with_stdio(false);
+            stats = ExpressionFile::evaluateFile(argv[1], cout, threads);
+            cout.flush();
+        }
+        cerr << stats.lines << " lines, " << stats.errors << " errors" << endl;
+    }
+    catch (const exception &e)
+    {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,447 @@
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Stack.h"
+
+// An infix formula compiled once into postfix bytecode and evaluated many times.
+//
+//   Expression e = Expression::compile("rate * (1 + x) ^ 2 - 3.5");
+//   double in[2];
+//   in[e.variable("rate")] = 0.25;
+//   in[e.variable("x")] = 4;
+//   double y = e.evaluate(in);
+//
+// Literals may be multi-digit or floating point, names start with a letter or '_',
+// '^' is right-associative and '-' may also be unary. Variables get slots in order
+// of first appearance. evaluate() only touches a scratch stack sized at compile
+// time, so it neither parses nor allocates; that scratch space also means one
+// Expression must not be evaluated from two threads at once (give each thread a copy).
+class Expression
+{
+public:
+    enum OpCode : uint8_t
+    {
+        Constant, // push constants[operand]
+        Variable, // push values[operand]
+        Add,
+        Sub,
+        Mul,
+        Div,
+        Pow,
+        Neg,
+        Save, // copy the top into temporaries[operand], leaving it on the stack
+        Load  // push temporaries[operand]
+    };
+
+    struct Instruction
+    {
+        OpCode op;
+        uint32_t operand;
+    };
+
+private:
+    vector<Instruction> code;
+    vector<double> constants;
+    vector<string> literals; // each constant as written, for exact number types
+    vector<string> variables;
+    int maxDepth;
+    int temporaries;
+    mutable vector<double> scratch; // maxDepth stack slots, then the temporaries
+
+    enum TokenKind
+    {
+        Number,
+        Name,
+        Operator,
+        LeftParen,
+        RightParen,
+        End
+    };
+
+    struct Token
+    {
+        TokenKind kind;
+        OpCode op;
+        double number;
+        string name;
+    };
+
+    // splits the infix text into tokens; `expectOperand` tells '-' apart
+    class Tokenizer
+    {
+    private:
+        const string &text;
+        size_t pos;
+
+    public:
+        Tokenizer(const string &infix) : text(infix), pos(0) {}
+
+        Token next(bool expectOperand)
+        {
+            while (pos < text.size() && isspace((unsigned char)text[pos]))
+                pos++;
+            Token t;
+            t.kind = End;
+            t.op = Add;
+            t.number = 0;
+            if (pos == text.size())
+                return t;
+
+            char ch = text[pos];
+            if (isdigit((unsigned char)ch) || ch == '.')
+            {
+                const char *start = text.c_str() + pos;
+                char *end;
+                t.number = strtod(start, &end);
+                if (end == start)
+                    throw runtime_error("Invalid number at position " + to_string(pos));
+                t.kind = Number;
+                t.name.assign(start, end - start);
+                pos += end - start;
+            }
+            else if (isalpha((unsigned char)ch) || ch == '_')
+            {
+                size_t start = pos;
+                while (pos < text.size() && (isalnum((unsigned char)text[pos]) || text[pos] == '_'))
+                    pos++;
+                t.kind = Name;
+                t.name = text.substr(start, pos - start);
+            }
+            else
+            {
+                pos++;
+                t.kind = Operator;
+                switch (ch)
+                {
+                case '(': t.kind = LeftParen; break;
+                case ')': t.kind = RightParen; break;
+                case '+': t.op = Add; break;
+                case '-': t.op = expectOperand ? Neg : Sub; break;
+                case '*': t.op = Mul; break;
+                case '/': t.op = Div; break;
+                case '^': t.op = Pow; break;
+                default: throw runtime_error(string("Invalid character: ") + ch);
+                }
+            }
+            return t;
+        }
+    };
+
+    static int precedence(OpCode op)
+    {
+        switch (op)
+        {
+        case Pow: return 4;
+        case Neg: return 3;
+        case Mul:
+        case Div: return 2;
+        default: return 1;
+        }
+    }
+
+    static bool rightAssociative(OpCode op)
+    {
+        return op == Pow || op == Neg;
+    }
+
+    void emit(OpCode op, uint32_t operand = 0)
+    {
+        code.push_back(Instruction{op, operand});
+    }
+
+    uint32_t slotOf(const string &name)
+    {
+        for (size_t i = 0; i < variables.size(); i++)
+        {
+            if (variables[i] == name)
+                return (uint32_t)i;
+        }
+        variables.push_back(name);
+        return (uint32_t)(variables.size() - 1);
+    }
+
+    // checks the program is well formed and sizes the scratch stack
+    void finish()
+    {
+        int depth = 0;
+        maxDepth = 0;
+        temporaries = 0;
+        vector<bool> saved;
+        for (const Instruction &in : code)
+        {
+            if (in.op == Constant || in.op == Variable)
+            {
+                if (in.operand >= (in.op == Constant ? constants.size() : variables.size()))
+                    throw runtime_error("Invalid expression");
+                depth++;
+            }
+            else if (in.op == Save)
+            {
+                if (in.operand >= saved.size())
+                    saved.resize(in.operand + 1);
+                saved[in.operand] = true;
+            }
+            else if (in.op == Load)
+            {
+                if (in.operand >= saved.size() || !saved[in.operand])
+                    throw runtime_error("Temporary loaded before it was saved");
+                depth++;
+            }
+            else if (in.op != Neg)
+                depth--;
+            if (depth < 1)
+                throw runtime_error("Invalid expression");
+            if (depth > maxDepth)
+                maxDepth = depth;
+        }
+        if (depth != 1)
+            throw runtime_error("Invalid expression");
+        temporaries = (int)saved.size();
+        scratch.assign(maxDepth + temporaries, 0.0);
+    }
+
+public:
+    Expression() : maxDepth(0), temporaries(0) {}
+
+    // builds an expression from bytecode produced elsewhere (see ExpressionOptimizer)
+    static Expression assemble(const vector<Instruction> &code, const vector<double> &constants,
+                               const vector<string> &variables)
+    {
+        Expression e;
+        e.code = code;
+        e.constants = constants;
+        e.variables = variables;
+        for (double c : constants)
+        {
+            char buffer[32];
+            snprintf(buffer, sizeof(buffer), c == floor(c) && fabs(c) < 1e18 ? "%.0f" : "%.17g", c);
+            e.literals.push_back(buffer);
+        }
+        e.finish();
+        return e;
+    }
+
+    // shunting-yard: operands go straight to the bytecode, operators wait on a Stack
+    static Expression compile(const string &infix)
+    {
+        Expression e;
+        Tokenizer tokens(infix);
+        Stack<Token> s((int)infix.size() + 1);
+        bool expectOperand = true;
+
+        for (Token t = tokens.next(true); t.kind != End; t = tokens.next(expectOperand))
+        {
+            if (t.kind == Number || t.kind == Name)
+            {
+                if (!expectOperand)
+                    throw runtime_error("Missing operator");
+                if (t.kind == Number)
+                {
+                    e.constants.push_back(t.number);
+                    e.literals.push_back(t.name);
+                    e.emit(Constant, (uint32_t)(e.constants.size() - 1));
+                }
+                else
+                    e.emit(Variable, e.slotOf(t.name));
+                expectOperand = false;
+            }
+            else if (t.kind == LeftParen)
+            {
+                if (!expectOperand)
+                    throw runtime_error("Missing operator");
+                s.push(t);
+            }
+            else if (t.kind == RightParen)
+            {
+                if (expectOperand)
+                    throw runtime_error("Invalid expression");
+                while (!s.isEmpty() && s.top().kind != LeftParen)
+                {
+                    e.emit(s.top().op);
+                    s.pop();
+                }
+                if (s.isEmpty())
+                    throw runtime_error("Mismatched parentheses");
+                s.pop();
+            }
+            else if (t.op == Neg)
+            {
+                // prefix operator: nothing on the stack is complete yet
+                s.push(t);
+            }
+            else
+            {
+                if (expectOperand)
+                    throw runtime_error("Invalid expression");
+                while (!s.isEmpty() && s.top().kind == Operator &&
+                       (precedence(s.top().op) > precedence(t.op) ||
+                        (precedence(s.top().op) == precedence(t.op) && !rightAssociative(t.op))))
+                {
+                    e.emit(s.top().op);
+                    s.pop();
+                }
+                s.push(t);
+                expectOperand = true;
+            }
+        }
+
+        while (!s.isEmpty())
+        {
+            if (s.top().kind == LeftParen)
+                throw runtime_error("Mismatched parentheses");
+            e.emit(s.top().op);
+            s.pop();
+        }
+        e.finish();
+        return e;
+    }
+
+    // x ^ n by repeated squaring when n is a whole number, pow() otherwise
+    static double power(double base, double exponent)
+    {
+        if (exponent != floor(exponent) || fabs(exponent) > 1e18)
+            return pow(base, exponent);
+        long long n = (long long)exponent;
+        bool invert = n < 0;
+        unsigned long long k = invert ? 0ULL - (unsigned long long)n : (unsigned long long)n;
+        double result = 1;
+        while (k != 0)
+        {
+            if (k & 1)
+                result *= base;
+            base *= base;
+            k >>= 1;
+        }
+        return invert ? 1 / result : result;
+    }
+
+    // values[i] is the value of variables()[i]
+    double evaluate(const double *values) const
+    {
+        double *top = scratch.data() - 1;
+        const double *k = constants.data();
+        double *t = scratch.data() + maxDepth;
+        for (const Instruction &in : code)
+        {
+            switch (in.op)
+            {
+            case Constant: *++top = k[in.operand]; break;
+            case Variable: *++top = values[in.operand]; break;
+            case Add: top[-1] += top[0]; top--; break;
+            case Sub: top[-1] -= top[0]; top--; break;
+            case Mul: top[-1] *= top[0]; top--; break;
+            case Div: top[-1] /= top[0]; top--; break;
+            case Pow: top[-1] = power(top[-1], top[0]); top--; break;
+            case Neg: top[0] = -top[0]; break;
+            case Save: t[in.operand] = *top; break;
+            case Load: *++top = t[in.operand]; break;
+            }
+        }
+        return *top;
+    }
+
+    double evaluate(const vector<double> &values) const
+    {
+        if (values.size() < variables.size())
+            throw runtime_error("Missing variable values");
+        return evaluate(values.data());
+    }
+
+    double evaluate() const
+    {
+        if (!variables.empty())
+            throw runtime_error("Missing variable values");
+        return evaluate(nullptr);
+    }
+
+    // slot of a variable in the values array
+    int variable(const string &name) const
+    {
+        for (size_t i = 0; i < variables.size(); i++)
+        {
+            if (variables[i] == name)
+                return (int)i;
+        }
+        throw runtime_error("Unknown variable: " + name);
+    }
+
+    const vector<string> &getVariables() const
+    {
+        return variables;
+    }
+
+    const vector<Instruction> &getCode() const
+    {
+        return code;
+    }
+
+    const vector<double> &getConstants() const
+    {
+        return constants;
+    }
+
+    const vector<string> &getLiterals() const
+    {
+        return literals;
+    }
+
+    int getMaxDepth() const
+    {
+        return maxDepth;
+    }
+
+    int getTemporaries() const
+    {
+        return temporaries;
+    }
+
+    // arithmetic instructions, i.e. everything but pushes and temporaries
+    int operationCount() const
+    {
+        int n = 0;
+        for (const Instruction &in : code)
+        {
+            if (in.op >= Add && in.op <= Neg)
+                n++;
+        }
+        return n;
+    }
+
+    // space separated postfix form; unary minus is written as '~', saving to
+    // temporary n as '=tn' and loading it back as 'tn'
+    string postfix() const
+    {
+        static const char symbols[] = "  +-*/^~";
+        string out;
+        for (const Instruction &in : code)
+        {
+            if (!out.empty())
+                out += ' ';
+            if (in.op == Constant)
+            {
+                char buffer[32];
+                snprintf(buffer, sizeof(buffer), "%g", constants[in.operand]);
+                out += buffer;
+            }
+            else if (in.op == Variable)
+                out += variables[in.operand];
+            else if (in.op == Save)
+                out += "=t" + to_string(in.operand);
+            else if (in.op == Load)
+                out += "t" + to_string(in.operand);
+            else
+                out += symbols[in.op];
+        }
+        return out;
+    }
+};
+
+#endif
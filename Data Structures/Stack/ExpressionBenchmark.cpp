@@ -0,0 +1,80 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include "Expression.h"
+using namespace std;
+
+double seconds(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    int evaluations = argc > 1 ? atoi(argv[1]) : 5000000;
+
+    const char *formulas[] = {
+        "3 + 8 * 2 + (6 / 2) * 7",
+        "price * (1 + rate) ^ years - fee",
+        "(a + b) * (a - b) / (c * c + 1) + a ^ 2 ^ 1 - -b",
+        "x * x * x - 2.5 * x * x + 0.75 * x - 12 + (x - 1) * (x + 1) / (x * x + 3)",
+    };
+
+    for (const char *formula : formulas)
+    {
+        int compiles = 200000;
+        auto start = chrono::steady_clock::now();
+        size_t checksum = 0;
+        for (int i = 0; i < compiles; i++)
+            checksum += Expression::compile(formula).getCode().size();
+        double compileTime = seconds(start) / compiles;
+
+        Expression e = Expression::compile(formula);
+        vector<double> values(e.getVariables().size());
+
+        // the same formula against a different binding every time
+        double sum = 0;
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < evaluations; i++)
+        {
+            for (size_t v = 0; v < values.size(); v++)
+                values[v] = (double)((i + (int)v) & 1023) * 0.01;
+            sum += e.evaluate(values.data());
+        }
+        double evalTime = seconds(start);
+
+        // what the old code did: parse the text again for every evaluation
+        int reparses = evaluations / 50;
+        double reparseSum = 0;
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < reparses; i++)
+        {
+            for (size_t v = 0; v < values.size(); v++)
+                values[v] = (double)((i + (int)v) & 1023) * 0.01;
+            reparseSum += Expression::compile(formula).evaluate(values.data());
+        }
+        double reparseTime = seconds(start) / reparses * evaluations;
+
+        cout << formula << '\n'
+             << "  " << e.getCode().size() << " instructions, stack depth " << e.getMaxDepth()
+             << ", compile " << compileTime * 1e6 << " us\n"
+             << "  compiled: " << evaluations / evalTime / 1e6 << " M evals/s, "
+             << "re-parsed each time: " << evaluations / reparseTime / 1e6 << " M evals/s"
+             << "  (checksum " << sum + reparseSum + (double)checksum << ")" << endl;
+    }
+
+    // baseline: the second formula written by hand
+    double sum = 0;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < evaluations; i++)
+    {
+        double price = (double)(i & 1023) * 0.01, rate = (double)((i + 1) & 1023) * 0.01;
+        double years = (double)((i + 2) & 1023) * 0.01, fee = (double)((i + 3) & 1023) * 0.01;
+        sum += price * pow(1 + rate, years) - fee;
+    }
+    cout << "hand-written price formula: " << evaluations / seconds(start) / 1e6 << " M evals/s"
+         << "  (checksum " << sum << ")" << endl;
+    return 0;
+}
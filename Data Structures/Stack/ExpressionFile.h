@@ -0,0 +1,367 @@
+#ifndef EXPRESSIONFILE_H
+#define EXPRESSIONFILE_H
+
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Stack.h"
+#include "Expression.h"
+
+// infixToPostfix and evaluatePostfix from StackApplications fused into one pass:
+// operators leave the operator stack straight into the evaluation instead of into a
+// postfix string. Both stacks live as long as the evaluator, so a thread can run it
+// over millions of lines without allocating. Same grammar as Expression, without
+// variables.
+class LineEvaluator
+{
+private:
+    Stack<char> operators;
+    Stack<double> values;
+
+    static int precedence(char op)
+    {
+        switch (op)
+        {
+        case '^': return 4;
+        case '~': return 3; // unary minus
+        case '*':
+        case '/': return 2;
+        case '+':
+        case '-': return 1;
+        default: return 0; // '('
+        }
+    }
+
+    bool apply(char op)
+    {
+        double b, a;
+        if (!values.try_pop(b))
+            return false;
+        if (op == '~')
+            return values.try_push(-b);
+        if (!values.try_pop(a))
+            return false;
+        switch (op)
+        {
+        case '+': a += b; break;
+        case '-': a -= b; break;
+        case '*': a *= b; break;
+        case '/': a /= b; break;
+        default: a = Expression::power(a, b); break;
+        }
+        return values.try_push(a);
+    }
+
+    void reset()
+    {
+        while (operators.try_pop())
+            ;
+        while (values.try_pop())
+            ;
+    }
+
+public:
+    LineEvaluator(int maxDepth = 256) : operators(maxDepth), values(maxDepth) {}
+
+    // evaluates [begin, end); on failure returns false and points error at a message
+    bool evaluate(const char *begin, const char *end, double &result, const char *&error)
+    {
+        reset();
+        bool expectOperand = true;
+        error = "Invalid expression";
+        for (const char *p = begin; p < end;)
+        {
+            char ch = *p;
+            if (ch == ' ' || ch == '\t' || ch == '\r')
+            {
+                p++;
+                continue;
+            }
+            if ((ch >= '0' && ch <= '9') || ch == '.')
+            {
+                double value;
+                from_chars_result r = from_chars(p, end, value);
+                if (r.ec != errc() || !expectOperand)
+                    return false;
+                if (!values.try_push(value))
+                {
+                    error = "Expression too deep";
+                    return false;
+                }
+                p = r.ptr;
+                expectOperand = false;
+                continue;
+            }
+            p++;
+            if (ch == '(')
+            {
+                if (!expectOperand || !operators.try_push(ch))
+                    return false;
+            }
+            else if (ch == ')')
+            {
+                if (expectOperand)
+                    return false;
+                while (!operators.isEmpty() && operators.top() != '(')
+                {
+                    if (!apply(operators.top()))
+                        return false;
+                    operators.pop();
+                }
+                if (!operators.try_pop())
+                {
+                    error = "Mismatched parentheses";
+                    return false;
+                }
+            }
+            else if (ch == '-' && expectOperand)
+            {
+                if (!operators.try_push('~'))
+                    return false;
+            }
+            else if (ch == '+' || ch == '-' || ch == '*' || ch == '/' || ch == '^')
+            {
+                if (expectOperand)
+                    return false;
+                // '^' is right-associative
+                while (!operators.isEmpty() && (precedence(operators.top()) > precedence(ch) ||
+                                                (precedence(operators.top()) == precedence(ch) && ch != '^')))
+                {
+                    if (!apply(operators.top()))
+                        return false;
+                    operators.pop();
+                }
+                if (!operators.try_push(ch))
+                {
+                    error = "Expression too deep";
+                    return false;
+                }
+                expectOperand = true;
+            }
+            else
+            {
+                error = "Invalid character";
+                return false;
+            }
+        }
+
+        while (!operators.isEmpty())
+        {
+            if (operators.top() == '(')
+            {
+                error = "Mismatched parentheses";
+                return false;
+            }
+            if (!apply(operators.top()))
+                return false;
+            operators.pop();
+        }
+        if (values.size() != 1)
+            return false;
+        result = values.top();
+        return true;
+    }
+};
+
+// Evaluates a file with one expression per line and writes one result per line, in
+// input order, to out. Lines that do not parse produce "error: <reason>"; blank lines
+// stay blank.
+//
+// The file is memory-mapped and cut into chunks of about chunkSize bytes that end on
+// line boundaries. Worker threads claim chunks from an atomic counter, each with its
+// own LineEvaluator and output buffer. Finished chunks go into a reorder buffer of
+// `window` slots and the calling thread writes them out strictly in chunk order;
+// workers that get more than `window` chunks ahead wait, so memory stays bounded.
+class ExpressionFile
+{
+public:
+    struct Stats
+    {
+        size_t bytes;
+        size_t lines;
+        size_t errors;
+    };
+
+private:
+    const char *data;
+    size_t length;
+    size_t chunkSize;
+
+    static string systemError(const string &what)
+    {
+        return what + ": " + strerror(errno);
+    }
+
+    // chunk k starts after the first newline at or past k * chunkSize - 1
+    size_t boundary(size_t k) const
+    {
+        if (k == 0)
+            return 0;
+        size_t at = k * chunkSize - 1;
+        if (at >= length)
+            return length;
+        const void *newline = memchr(data + at, '\n', length - at);
+        return newline == nullptr ? length : (size_t)((const char *)newline - data) + 1;
+    }
+
+    static void evaluateChunk(LineEvaluator &evaluator, const char *p, const char *end, string &out, Stats &stats)
+    {
+        char number[32];
+        while (p < end)
+        {
+            const char *newline = (const char *)memchr(p, '\n', end - p);
+            const char *lineEnd = newline == nullptr ? end : newline;
+            const char *next = newline == nullptr ? end : newline + 1;
+
+            const char *q = p;
+            while (q < lineEnd && (*q == ' ' || *q == '\t' || *q == '\r'))
+                q++;
+            if (q < lineEnd)
+            {
+                double result;
+                const char *error;
+                if (evaluator.evaluate(p, lineEnd, result, error))
+                {
+                    to_chars_result r = to_chars(number, number + sizeof(number), result);
+                    out.append(number, r.ptr);
+                }
+                else
+                {
+                    out += "error: ";
+                    out += error;
+                    stats.errors++;
+                }
+            }
+            out += '\n';
+            stats.lines++;
+            p = next;
+        }
+    }
+
+public:
+    ExpressionFile(const char *text, size_t size, size_t chunk = 1 << 20)
+        : data(text), length(size), chunkSize(chunk == 0 ? 1 : chunk) {}
+
+    // in-memory input; the file overload below maps a path and calls this
+    Stats evaluate(ostream &out, int threads = 0, int window = 0)
+    {
+        if (threads <= 0)
+            threads = max(1, (int)thread::hardware_concurrency());
+        if (window <= 0)
+            window = 4 * threads;
+
+        size_t chunks = (length + chunkSize - 1) / chunkSize;
+        vector<string> slots(window);
+        vector<char> ready(window, 0);
+        vector<Stats> perThread(threads, Stats{0, 0, 0});
+        atomic<size_t> nextChunk(0);
+        size_t written = 0; // guarded by lock
+        mutex lock;
+        condition_variable chunkDone, slotFree;
+
+        auto worker = [&](int id)
+        {
+            LineEvaluator evaluator;
+            while (true)
+            {
+                size_t k = nextChunk.fetch_add(1, memory_order_relaxed);
+                if (k >= chunks)
+                    break;
+                {
+                    unique_lock<mutex> guard(lock);
+                    slotFree.wait(guard, [&]
+                                  { return k < written + window; });
+                }
+                string buffer;
+                size_t begin = boundary(k), end = boundary(k + 1);
+                buffer.reserve((end - begin) / 2 + 16);
+                evaluateChunk(evaluator, data + begin, data + end, buffer, perThread[id]);
+                {
+                    lock_guard<mutex> guard(lock);
+                    slots[k % window] = move(buffer);
+                    ready[k % window] = 1;
+                }
+                chunkDone.notify_one();
+            }
+        };
+
+        vector<thread> pool;
+        for (int i = 0; i < threads; i++)
+            pool.emplace_back(worker, i);
+
+        // the reorder buffer drains here, in chunk order
+        while (written < chunks)
+        {
+            string buffer;
+            {
+                unique_lock<mutex> guard(lock);
+                chunkDone.wait(guard, [&]
+                               { return ready[written % window] != 0; });
+                buffer = move(slots[written % window]);
+                ready[written % window] = 0;
+                written++;
+            }
+            slotFree.notify_all();
+            out.write(buffer.data(), (streamsize)buffer.size());
+        }
+        for (thread &t : pool)
+            t.join();
+
+        Stats total{length, 0, 0};
+        for (const Stats &s : perThread)
+        {
+            total.lines += s.lines;
+            total.errors += s.errors;
+        }
+        return total;
+    }
+
+    static Stats evaluateFile(const string &path, ostream &out, int threads = 0, size_t chunk = 1 << 20)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw runtime_error(systemError("Cannot open " + path));
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+        {
+            close(fd);
+            throw runtime_error(systemError("Cannot stat " + path));
+        }
+        size_t size = (size_t)st.st_size;
+        if (size == 0)
+        {
+            close(fd);
+            return Stats{0, 0, 0};
+        }
+        void *p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED)
+            throw runtime_error(systemError("Cannot map " + path));
+        madvise(p, size, MADV_SEQUENTIAL);
+
+        try
+        {
+            Stats stats = ExpressionFile((const char *)p, size, chunk).evaluate(out, threads);
+            munmap(p, size);
+            return stats;
+        }
+        catch (...)
+        {
+            munmap(p, size);
+            throw;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,90 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include "ExpressionFile.h"
+using namespace std;
+
+double seconds(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// swallows the output but keeps an FNV-1a hash of it, so runs can be compared
+class HashBuffer : public streambuf
+{
+public:
+    uint64_t hash = 1469598103934665603ULL;
+
+protected:
+    streamsize xsputn(const char *s, streamsize n) override
+    {
+        for (streamsize i = 0; i < n; i++)
+            hash = (hash ^ (unsigned char)s[i]) * 1099511628211ULL;
+        return n;
+    }
+
+    int overflow(int c) override
+    {
+        if (c != EOF)
+        {
+            char ch = (char)c;
+            xsputn(&ch, 1);
+        }
+        return c;
+    }
+};
+
+string randomExpression(mt19937 &rng, int depth)
+{
+    static const char ops[] = "+-*/^";
+    if (depth == 0 || rng() % 4 == 0)
+    {
+        if (rng() % 3 == 0)
+            return to_string(rng() % 1000) + "." + to_string(rng() % 100);
+        return to_string(rng() % 100000);
+    }
+    char op = ops[rng() % (rng() % 8 == 0 ? 5 : 4)];
+    string right = op == '^' ? to_string(rng() % 4) : randomExpression(rng, depth - 1);
+    return "(" + randomExpression(rng, depth - 1) + " " + op + " " + right + ")";
+}
+
+int main(int argc, char **argv)
+{
+    int megabytes = argc > 1 ? atoi(argv[1]) : 64;
+    int maxThreads = argc > 2 ? atoi(argv[2]) : max(1, (int)thread::hardware_concurrency());
+    string path = "/tmp/expressions_benchmark.txt";
+
+    {
+        mt19937 rng(11);
+        ofstream file(path, ios::binary);
+        size_t size = 0;
+        for (int i = 0; size < (size_t)megabytes << 20; i++)
+        {
+            string line = i % 1000 == 999 ? "2 + * 3" : randomExpression(rng, 4);
+            line += '\n';
+            file << line;
+            size += line.size();
+        }
+    }
+
+    uint64_t reference = 0;
+    for (int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        HashBuffer sink;
+        ostream out(&sink);
+        auto start = chrono::steady_clock::now();
+        ExpressionFile::Stats stats = ExpressionFile::evaluateFile(path, out, threads);
+        double elapsed = seconds(start);
+        if (threads == 1)
+            reference = sink.hash;
+        cout << threads << " thread(s): " << stats.bytes / elapsed / (1 << 20) << " MB/s, "
+             << stats.lines / elapsed / 1e6 << " M expressions/s (" << stats.lines << " lines, "
+             << stats.errors << " errors)" << (sink.hash == reference ? "" : "  OUTPUT DIFFERS") << endl;
+    }
+    remove(path.c_str());
+    return 0;
+}
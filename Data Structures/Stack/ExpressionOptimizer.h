@@ -0,0 +1,363 @@
+#ifndef EXPRESSIONOPTIMIZER_H
+#define EXPRESSIONOPTIMIZER_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "Expression.h"
+#include "ColumnEvaluator.h"
+
+// Rewrites a compiled Expression into a smaller one that computes the same thing.
+// The postfix program is turned into a DAG in which every distinct sub-expression is
+// one node (so `(a + b) * (a + b)` computes a + b once). While the DAG is built,
+// constant sub-trees are folded and algebraic identities applied, and the DAG is then
+// written back out as postfix. A node used more than once is computed the first time,
+// saved to a temporary and loaded again afterwards.
+//
+// What is safe depends on how the result will be evaluated:
+//  - IntegerSemantics matches ColumnEvaluator<long long> (wrapping + - *, truncating
+//    constants) and also allows x * 0 -> 0, x - x -> 0, x + 0 -> x and 0 - x -> -x;
+//  - FloatingSemantics matches Expression::evaluate and only uses identities that are
+//    exact in IEEE arithmetic, including for inf, nan and -0.
+// Division by a constant zero is never folded, and no identity drops a sub-expression
+// that might divide by zero, so ColumnEvaluator still flags the same rows.
+class ExpressionOptimizer
+{
+public:
+    enum Semantics
+    {
+        IntegerSemantics,
+        FloatingSemantics
+    };
+
+    struct Report
+    {
+        int operationsBefore;
+        int operationsAfter;
+        int folded;     // operators replaced by a constant
+        int simplified; // operators removed by an identity
+        int shared;     // times a computed sub-expression is loaded instead of recomputed
+
+        int eliminated() const
+        {
+            return operationsBefore - operationsAfter;
+        }
+    };
+
+    static Expression optimize(const Expression &e, Semantics semantics = IntegerSemantics, Report *report = nullptr)
+    {
+        ExpressionOptimizer o(e, semantics);
+        o.build();
+        Expression result = o.emit();
+        if (report != nullptr)
+        {
+            *report = o.stats;
+            report->operationsBefore = e.operationCount();
+            report->operationsAfter = result.operationCount();
+        }
+        return result;
+    }
+
+private:
+    typedef Expression::OpCode OpCode;
+    typedef ColumnEvaluator<long long> Integer;
+
+    struct Node
+    {
+        OpCode op;
+        double value;  // Constant
+        int operand;   // Variable slot
+        int left;
+        int right;     // -1 for Neg and leaves
+        bool divides;  // contains a division whose divisor is not a nonzero constant
+    };
+
+    const Expression &source;
+    Semantics semantics;
+    vector<Node> nodes;
+    map<tuple<int, int, int, uint64_t>, int> unique; // (op, left, right, constant bits or slot)
+    Report stats;
+    int root;
+
+    ExpressionOptimizer(const Expression &e, Semantics s) : source(e), semantics(s), root(-1)
+    {
+        stats = Report{0, 0, 0, 0, 0};
+    }
+
+    bool integer() const
+    {
+        return semantics == IntegerSemantics;
+    }
+
+    bool isConstant(int id) const
+    {
+        return nodes[id].op == Expression::Constant;
+    }
+
+    bool isConstant(int id, double value) const
+    {
+        return isConstant(id) && nodes[id].value == value;
+    }
+
+    int intern(const Node &n, uint64_t extra)
+    {
+        tuple<int, int, int, uint64_t> key(n.op, n.left, n.right, extra);
+        auto it = unique.find(key);
+        if (it != unique.end())
+            return it->second;
+        nodes.push_back(n);
+        unique[key] = (int)nodes.size() - 1;
+        return (int)nodes.size() - 1;
+    }
+
+    int constant(double value)
+    {
+        if (integer() && fabs(value) < 9.2e18)
+            value = (double)(long long)value + 0.0; // + 0.0 turns -0 into 0
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return intern(Node{Expression::Constant, value, 0, -1, -1, false}, bits);
+    }
+
+    int variable(int slot)
+    {
+        return intern(Node{Expression::Variable, 0, slot, -1, -1, false}, (uint64_t)slot);
+    }
+
+    // the value of a op b on constants, or false if it must stay a runtime operation
+    bool fold(OpCode op, double a, double b, double &out) const
+    {
+        if (op == Expression::Div && b == 0)
+            return false;
+        if (!integer())
+        {
+            switch (op)
+            {
+            case Expression::Add: out = a + b; break;
+            case Expression::Sub: out = a - b; break;
+            case Expression::Mul: out = a * b; break;
+            case Expression::Div: out = a / b; break;
+            case Expression::Pow: out = Expression::power(a, b); break;
+            default: out = -a; break;
+            }
+            return true;
+        }
+        long long x = (long long)a, y = (long long)b, r;
+        switch (op)
+        {
+        case Expression::Add: r = Integer::AddOp()(x, y); break;
+        case Expression::Sub: r = Integer::SubOp()(x, y); break;
+        case Expression::Mul: r = Integer::MulOp()(x, y); break;
+        case Expression::Div: r = Integer::DivOp()(x, y); break;
+        case Expression::Pow: r = Integer::PowOp()(x, y); break;
+        default: r = Integer::MulOp()(x, -1); break;
+        }
+        // constants are stored as doubles, which are exact only up to 2^53
+        if (r > (1LL << 53) || r < -(1LL << 53))
+            return false;
+        out = (double)r;
+        return true;
+    }
+
+    int negate(int child)
+    {
+        if (nodes[child].op == Expression::Neg)
+        {
+            stats.simplified++;
+            return nodes[child].left;
+        }
+        double value;
+        if (isConstant(child) && fold(Expression::Neg, nodes[child].value, 0, value))
+        {
+            stats.folded++;
+            return constant(value);
+        }
+        return intern(Node{Expression::Neg, 0, 0, child, -1, nodes[child].divides}, 0);
+    }
+
+    int binary(OpCode op, int l, int r)
+    {
+        double value;
+        if (isConstant(l) && isConstant(r) && fold(op, nodes[l].value, nodes[r].value, value))
+        {
+            stats.folded++;
+            return constant(value);
+        }
+
+        bool commutative = op == Expression::Add || op == Expression::Mul;
+        if (commutative && isConstant(l) && !isConstant(r))
+            swap(l, r);
+
+        int simplified = -1;
+        switch (op)
+        {
+        case Expression::Add:
+            if (integer() && isConstant(r, 0))
+                simplified = l;
+            break;
+        case Expression::Sub:
+            // x - (-0) is x + 0, which turns -0 into 0
+            if (isConstant(r, 0) && !signbit(nodes[r].value))
+                simplified = l;
+            else if (integer() && l == r && !nodes[l].divides)
+                simplified = constant(0);
+            else if (integer() && isConstant(l, 0))
+                simplified = negate(r);
+            break;
+        case Expression::Mul:
+            if (isConstant(r, 1))
+                simplified = l;
+            else if (isConstant(r, -1))
+                simplified = negate(l);
+            else if (integer() && isConstant(r, 0) && !nodes[l].divides)
+                simplified = constant(0);
+            break;
+        case Expression::Div:
+            if (isConstant(r, 1))
+                simplified = l;
+            else if (isConstant(r, -1))
+                simplified = negate(l);
+            break;
+        case Expression::Pow:
+            if (isConstant(r, 1))
+                simplified = l;
+            else if (isConstant(r, 0) && !nodes[l].divides)
+                simplified = constant(1);
+            break;
+        default:
+            break;
+        }
+        if (simplified >= 0)
+        {
+            stats.simplified++;
+            return simplified;
+        }
+
+        // a + b and b + a are the same node
+        if (commutative && l > r)
+            swap(l, r);
+        bool divides = nodes[l].divides || nodes[r].divides ||
+                       (op == Expression::Div && !(isConstant(r) && nodes[r].value != 0));
+        return intern(Node{op, 0, 0, l, r, divides}, 0);
+    }
+
+    // replays the program on a stack of node ids
+    void build()
+    {
+        vector<int> s;
+        vector<int> temporaries(source.getTemporaries(), -1);
+        const vector<double> &constants = source.getConstants();
+        for (const Expression::Instruction &in : source.getCode())
+        {
+            switch (in.op)
+            {
+            case Expression::Constant:
+                s.push_back(constant(constants[in.operand]));
+                break;
+            case Expression::Variable:
+                s.push_back(variable((int)in.operand));
+                break;
+            case Expression::Save:
+                temporaries[in.operand] = s.back();
+                break;
+            case Expression::Load:
+                s.push_back(temporaries[in.operand]);
+                break;
+            case Expression::Neg:
+                s.back() = negate(s.back());
+                break;
+            default:
+            {
+                int r = s.back();
+                s.pop_back();
+                s.back() = binary(in.op, s.back(), r);
+                break;
+            }
+            }
+        }
+        root = s.back();
+    }
+
+    // how many times each node reachable from root is referenced; iterative, like
+    // build(), so a long operator chain cannot overflow the call stack
+    vector<int> countUses() const
+    {
+        vector<int> uses(nodes.size(), 0);
+        vector<int> pending(1, root);
+        while (!pending.empty())
+        {
+            int id = pending.back();
+            pending.pop_back();
+            if (uses[id]++ > 0)
+                continue;
+            if (nodes[id].left >= 0)
+                pending.push_back(nodes[id].left);
+            if (nodes[id].right >= 0)
+                pending.push_back(nodes[id].right);
+        }
+        return uses;
+    }
+
+    // writes the DAG out as postfix, walking it with an explicit stack of
+    // (node, children emitted so far)
+    Expression emit()
+    {
+        vector<int> uses = countUses();
+        vector<int> temporary(nodes.size(), -1);
+        int temporaries = 0;
+        vector<Expression::Instruction> code;
+        vector<double> constants;
+
+        vector<pair<int, int>> pending(1, make_pair(root, 0));
+        while (!pending.empty())
+        {
+            int id = pending.back().first;
+            int done = pending.back().second;
+            const Node &n = nodes[id];
+            if (done == 0)
+            {
+                if (temporary[id] >= 0)
+                {
+                    code.push_back(Expression::Instruction{Expression::Load, (uint32_t)temporary[id]});
+                    stats.shared++;
+                    pending.pop_back();
+                    continue;
+                }
+                if (n.op == Expression::Constant)
+                {
+                    constants.push_back(n.value);
+                    code.push_back(Expression::Instruction{Expression::Constant, (uint32_t)(constants.size() - 1)});
+                    pending.pop_back();
+                    continue;
+                }
+                if (n.op == Expression::Variable)
+                {
+                    code.push_back(Expression::Instruction{Expression::Variable, (uint32_t)n.operand});
+                    pending.pop_back();
+                    continue;
+                }
+            }
+            if (done == 0 || (done == 1 && n.right >= 0))
+            {
+                pending.back().second++;
+                pending.push_back(make_pair(done == 0 ? n.left : n.right, 0));
+                continue;
+            }
+            code.push_back(Expression::Instruction{n.op, 0});
+            if (uses[id] > 1)
+            {
+                temporary[id] = temporaries++;
+                code.push_back(Expression::Instruction{Expression::Save, (uint32_t)temporary[id]});
+            }
+            pending.pop_back();
+        }
+        // same variable slots as the source, so existing bindings keep working
+        return Expression::assemble(code, constants, source.getVariables());
+    }
+};
+
+#endif
@@ -0,0 +1,161 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include "ExpressionOptimizer.h"
+using namespace std;
+
+double seconds(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// random formulas shaped like the ones in our configs: constant sub-terms such as
+// (6 / 2) * 7 and the same sub-expression showing up more than once
+class Generator
+{
+private:
+    mt19937 rng;
+    vector<string> pool;
+
+    int pick(int n)
+    {
+        return (int)(rng() % n);
+    }
+
+public:
+    Generator(unsigned seed) : rng(seed) {}
+
+    string term(int depth)
+    {
+        static const char *names[] = {"x", "y", "z", "w"};
+        static const char ops[] = "+-*+-*/";
+        int roll = pick(10);
+        if (depth == 0 || roll == 0)
+            return pick(2) ? names[pick(4)] : to_string(pick(9) + 1);
+        if (roll == 1)
+            return "(" + to_string(pick(20) + 1) + " " + ops[pick(7)] + " " + to_string(pick(9) + 1) + ")";
+        if (roll == 2 && !pool.empty())
+            return pool[pick((int)pool.size())];
+        if (roll == 3)
+            return "(" + term(depth - 1) + " * 1 + 0)";
+        string t = "(" + term(depth - 1) + " " + ops[pick(7)] + " " + term(depth - 1) + ")";
+        if (pool.size() < 64)
+            pool.push_back(t);
+        else
+            pool[pick(64)] = t;
+        return t;
+    }
+};
+
+int main(int argc, char **argv)
+{
+    int formulas = argc > 1 ? atoi(argv[1]) : 200;
+    int evaluations = argc > 2 ? atoi(argv[2]) : 20000;
+
+    Generator generate(42);
+    vector<Expression> original, optimized;
+    long long before = 0, after = 0, folded = 0, simplified = 0, shared = 0;
+    for (int i = 0; i < formulas; i++)
+    {
+        string text = generate.term(5);
+        Expression e = Expression::compile(text);
+        ExpressionOptimizer::Report report;
+        Expression o = ExpressionOptimizer::optimize(e, ExpressionOptimizer::FloatingSemantics, &report);
+        if (i < 5)
+        {
+            cout << text << "\n  " << report.operationsBefore << " -> " << report.operationsAfter
+                 << " operations (" << report.folded << " folded, " << report.simplified << " simplified, "
+                 << report.shared << " shared)\n";
+        }
+        before += report.operationsBefore;
+        after += report.operationsAfter;
+        folded += report.folded;
+        simplified += report.simplified;
+        shared += report.shared;
+        original.push_back(e);
+        optimized.push_back(o);
+    }
+    cout << "corpus of " << formulas << " formulas: " << before << " -> " << after << " operations, "
+         << folded << " folded, " << simplified << " simplified, " << shared << " shared" << endl;
+
+    // scalar VM, double semantics
+    double values[4];
+    bool same = true;
+    for (int i = 0; i < 17; i++)
+    {
+        for (int v = 0; v < 4; v++)
+            values[v] = (double)((i * (v + 3)) % 17) - 8.5;
+        for (int f = 0; f < formulas; f++)
+        {
+            double x = original[f].evaluate(values), y = optimized[f].evaluate(values);
+            same = same && (x == y || (isnan(x) && isnan(y)));
+        }
+    }
+    long long nonzero[2] = {0, 0}; // keeps the results alive without summing infs and nans
+    double times[2];
+    for (int pass = 0; pass < 2; pass++)
+    {
+        vector<Expression> &set = pass == 0 ? original : optimized;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < evaluations; i++)
+        {
+            for (int v = 0; v < 4; v++)
+                values[v] = (double)((i * (v + 3)) % 17) - 8.5;
+            for (Expression &e : set)
+                nonzero[pass] += e.evaluate(values) != 0;
+        }
+        times[pass] = seconds(start);
+    }
+    double total = (double)evaluations * formulas;
+    cout << "scalar VM: " << total / times[0] / 1e6 << " -> " << total / times[1] / 1e6 << " M evals/s"
+         << (same && nonzero[0] == nonzero[1] ? "" : "  MISMATCH") << endl;
+
+    // column-at-a-time, integer semantics
+    int rows = 4096;
+    vector<long long> columnData[4];
+    vector<const long long *> columns;
+    for (int v = 0; v < 4; v++)
+    {
+        columnData[v].resize(rows);
+        for (int i = 0; i < rows; i++)
+            columnData[v][i] = (i * (v + 3)) % 17 - 8;
+        columns.push_back(columnData[v].data());
+    }
+    vector<ColumnEvaluator<long long>> plain, reduced;
+    for (int i = 0; i < formulas; i++)
+    {
+        plain.emplace_back(original[i]);
+        reduced.emplace_back(ExpressionOptimizer::optimize(original[i], ExpressionOptimizer::IntegerSemantics));
+    }
+    vector<long long> a(rows), b(rows);
+    vector<uint8_t> ea(rows), eb(rows);
+    int repeats = evaluations / rows * 4 + 1;
+    same = true;
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+    {
+        for (int i = 0; i < formulas; i++)
+            plain[i].evaluate(columns.data(), rows, a.data(), ea.data());
+    }
+    double plainTime = seconds(start);
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+    {
+        for (int i = 0; i < formulas; i++)
+            reduced[i].evaluate(columns.data(), rows, b.data(), eb.data());
+    }
+    double reducedTime = seconds(start);
+    for (int i = 0; i < formulas; i++)
+    {
+        plain[i].evaluate(columns.data(), rows, a.data(), ea.data());
+        reduced[i].evaluate(columns.data(), rows, b.data(), eb.data());
+        same = same && a == b && ea == eb;
+    }
+    total = (double)repeats * rows * formulas;
+    cout << "columns (int64): " << total / plainTime / 1e6 << " -> " << total / reducedTime / 1e6 << " M rows/s"
+         << (same ? "" : "  MISMATCH") << endl;
+    return 0;
+}
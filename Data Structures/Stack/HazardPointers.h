@@ -0,0 +1,172 @@
+#ifndef HAZARDPOINTERS_H
+#define HAZARDPOINTERS_H
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "StackException.h"
+
+// Minimal hazard-pointer domain used by the lock-free containers in this folder.
+// A thread publishes the node it is about to dereference in its hazard slot; a
+// node unlinked from a structure is retired instead of deleted, and retired nodes
+// are only freed once no slot points at them. Each thread owns one slot, claimed
+// on first use and released when the thread exits.
+class HazardPointers
+{
+public:
+    static const int maxThreads = 256;
+
+private:
+    struct Record
+    {
+        atomic<bool> active;
+        atomic<void *> pointer;
+    };
+
+    struct Retired
+    {
+        void *pointer;
+        void (*deleter)(void *);
+    };
+
+    static Record *records()
+    {
+        static Record table[maxThreads];
+        return table;
+    }
+
+    // nodes left behind by exited threads that were still hazardous at the time
+    static mutex &orphanLock()
+    {
+        static mutex m;
+        return m;
+    }
+
+    static vector<Retired> &orphans()
+    {
+        static vector<Retired> list;
+        return list;
+    }
+
+    class ThreadState
+    {
+    public:
+        Record *record;
+        vector<Retired> retired;
+
+        ThreadState()
+        {
+            record = nullptr;
+            Record *table = records();
+            for (int i = 0; i < maxThreads; i++)
+            {
+                bool expected = false;
+                if (!table[i].active.load(memory_order_relaxed) &&
+                    table[i].active.compare_exchange_strong(expected, true))
+                {
+                    record = &table[i];
+                    break;
+                }
+            }
+            if (record == nullptr)
+            {
+                throw StackException("Too many threads for the hazard pointer domain");
+            }
+        }
+
+        ~ThreadState()
+        {
+            record->pointer.store(nullptr, memory_order_release);
+            scan(retired);
+            if (!retired.empty())
+            {
+                lock_guard<mutex> lock(orphanLock());
+                orphans().insert(orphans().end(), retired.begin(), retired.end());
+            }
+            record->active.store(false, memory_order_release);
+        }
+    };
+
+    static ThreadState &state()
+    {
+        thread_local ThreadState s;
+        return s;
+    }
+
+    // frees every retired node that no thread currently protects
+    static void scan(vector<Retired> &retired)
+    {
+        vector<void *> hazards;
+        Record *table = records();
+        for (int i = 0; i < maxThreads; i++)
+        {
+            void *p = table[i].pointer.load(memory_order_seq_cst);
+            if (p != nullptr)
+                hazards.push_back(p);
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < retired.size(); i++)
+        {
+            bool hazardous = false;
+            for (void *h : hazards)
+            {
+                if (h == retired[i].pointer)
+                {
+                    hazardous = true;
+                    break;
+                }
+            }
+            if (hazardous)
+                retired[kept++] = retired[i];
+            else
+                retired[i].deleter(retired[i].pointer);
+        }
+        retired.resize(kept);
+    }
+
+public:
+    // loads src and publishes it in this thread's slot until the value is stable
+    template <typename T>
+    static T *protect(const atomic<T *> &src)
+    {
+        atomic<void *> &slot = state().record->pointer;
+        T *p = src.load(memory_order_relaxed);
+        while (true)
+        {
+            slot.store(p, memory_order_seq_cst);
+            T *again = src.load(memory_order_acquire);
+            if (again == p)
+                return p;
+            p = again;
+        }
+    }
+
+    static void clear()
+    {
+        state().record->pointer.store(nullptr, memory_order_release);
+    }
+
+    template <typename T>
+    static void retire(T *p)
+    {
+        ThreadState &s = state();
+        s.retired.push_back(Retired{p, [](void *q)
+                                    { delete static_cast<T *>(q); }});
+        if (s.retired.size() >= 2 * (size_t)maxThreads)
+        {
+            {
+                lock_guard<mutex> lock(orphanLock());
+                if (!orphans().empty())
+                {
+                    s.retired.insert(s.retired.end(), orphans().begin(), orphans().end());
+                    orphans().clear();
+                }
+            }
+            scan(s.retired);
+        }
+    }
+};
+
+#endif
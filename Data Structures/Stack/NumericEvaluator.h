@@ -0,0 +1,202 @@
+#ifndef NUMERICEVALUATOR_H
+#define NUMERICEVALUATOR_H
+
+#include <charconv>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "Expression.h"
+
+// How the evaluators compute with a number type. The primary template covers the
+// built-in integers with overflow detection: + - * / ^ and unary minus throw
+// runtime_error("Integer overflow") instead of wrapping, and division by zero throws
+// too. Division truncates toward zero. A negative exponent truncates the same way, so
+// only 1 and -1 survive it. Floating point types and BigInt have their own
+// specializations.
+template <typename T, typename Enable = void>
+struct NumberTraits
+{
+    static_assert(is_integral<T>::value, "no NumberTraits for this type");
+
+    static void overflow()
+    {
+        throw runtime_error("Integer overflow");
+    }
+
+    static T fromLiteral(const string &text)
+    {
+        T value;
+        from_chars_result r = from_chars(text.data(), text.data() + text.size(), value);
+        if (r.ec == errc::result_out_of_range)
+            overflow();
+        if (r.ec != errc() || r.ptr != text.data() + text.size())
+            throw runtime_error("Not an integer: " + text);
+        return value;
+    }
+
+    static T add(T a, T b)
+    {
+        T r;
+        if (__builtin_add_overflow(a, b, &r))
+            overflow();
+        return r;
+    }
+
+    static T subtract(T a, T b)
+    {
+        T r;
+        if (__builtin_sub_overflow(a, b, &r))
+            overflow();
+        return r;
+    }
+
+    static T multiply(T a, T b)
+    {
+        T r;
+        if (__builtin_mul_overflow(a, b, &r))
+            overflow();
+        return r;
+    }
+
+    static T divide(T a, T b)
+    {
+        if (b == 0)
+            throw runtime_error("Division by zero");
+        if (is_signed<T>::value && a == numeric_limits<T>::min() && b == (T)-1)
+            overflow();
+        return a / b;
+    }
+
+    static T negate(T a)
+    {
+        return subtract(0, a);
+    }
+
+    // a ^ b for b < 0, truncated toward zero like division
+    static T negativePower(bool isOne, bool isMinusOne, bool isZero, bool oddExponent)
+    {
+        if (isZero)
+            throw runtime_error("Division by zero");
+        if (isOne)
+            return 1;
+        if (isMinusOne)
+            return oddExponent ? (T)-1 : (T)1;
+        return 0;
+    }
+
+    // exponentiation by squaring, checked at every step
+    static T power(T a, T b)
+    {
+        if (b < 0)
+            return negativePower(a == 1, a == (T)-1, a == 0, (b & 1) != 0);
+        T result = 1;
+        while (true)
+        {
+            if (b & 1)
+                result = multiply(result, a);
+            b >>= 1;
+            if (b == 0)
+                return result;
+            a = multiply(a, a);
+        }
+    }
+
+    static string toString(T a)
+    {
+        return to_string(a);
+    }
+};
+
+template <typename T>
+struct NumberTraits<T, typename enable_if<is_floating_point<T>::value>::type>
+{
+    static T fromLiteral(const string &text)
+    {
+        return (T)strtod(text.c_str(), nullptr);
+    }
+
+    static T add(T a, T b) { return a + b; }
+    static T subtract(T a, T b) { return a - b; }
+    static T multiply(T a, T b) { return a * b; }
+    static T divide(T a, T b) { return a / b; }
+    static T negate(T a) { return -a; }
+    static T power(T a, T b) { return (T)Expression::power((double)a, (double)b); }
+
+    static string toString(T a)
+    {
+        char buffer[32];
+        to_chars_result r = to_chars(buffer, buffer + sizeof(buffer), a);
+        return string(buffer, r.ptr);
+    }
+};
+
+// Runs an Expression's bytecode in any number type that has NumberTraits: checked
+// long long, double and BigInt all go through this one loop. Constants are converted
+// from their literal text once, when the evaluator is built, so a BigInt literal keeps
+// every digit (an ExpressionOptimizer pass goes through double and would not).
+// Like Expression, an evaluator keeps its stack between calls and must not be shared
+// between threads.
+template <typename Number>
+class NumericEvaluator
+{
+private:
+    typedef NumberTraits<Number> Traits;
+
+    vector<Expression::Instruction> code;
+    vector<Number> constants;
+    vector<Number> stack;
+    vector<Number> temporaries;
+    size_t variableCount;
+
+public:
+    NumericEvaluator(const Expression &e)
+        : code(e.getCode()), stack(e.getMaxDepth()), temporaries(e.getTemporaries()),
+          variableCount(e.getVariables().size())
+    {
+        for (const string &literal : e.getLiterals())
+            constants.push_back(Traits::fromLiteral(literal));
+    }
+
+    // values[i] is the value of the expression's variable i
+    Number evaluate(const Number *values)
+    {
+        Number *s = stack.data();
+        int top = -1;
+        for (const Expression::Instruction &in : code)
+        {
+            switch (in.op)
+            {
+            case Expression::Constant: s[++top] = constants[in.operand]; break;
+            case Expression::Variable: s[++top] = values[in.operand]; break;
+            case Expression::Add: s[top - 1] = Traits::add(s[top - 1], s[top]); top--; break;
+            case Expression::Sub: s[top - 1] = Traits::subtract(s[top - 1], s[top]); top--; break;
+            case Expression::Mul: s[top - 1] = Traits::multiply(s[top - 1], s[top]); top--; break;
+            case Expression::Div: s[top - 1] = Traits::divide(s[top - 1], s[top]); top--; break;
+            case Expression::Pow: s[top - 1] = Traits::power(s[top - 1], s[top]); top--; break;
+            case Expression::Neg: s[top] = Traits::negate(s[top]); break;
+            case Expression::Save: temporaries[in.operand] = s[top]; break;
+            case Expression::Load: s[++top] = temporaries[in.operand]; break;
+            }
+        }
+        return s[0];
+    }
+
+    Number evaluate(const vector<Number> &values)
+    {
+        if (values.size() < variableCount)
+            throw runtime_error("Missing variable values");
+        return evaluate(values.data());
+    }
+
+    Number evaluate()
+    {
+        if (variableCount != 0)
+            throw runtime_error("Missing variable values");
+        return evaluate(nullptr);
+    }
+};
+
+#endif
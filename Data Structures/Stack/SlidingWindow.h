@@ -0,0 +1,111 @@
+#ifndef SLIDINGWINDOW_H
+#define SLIDINGWINDOW_H
+
+#include <utility>
+#if __cplusplus >= 202002L
+#include <span>
+#endif
+#include "Stack.h"
+
+// FIFO window over the last `window` samples that answers op(oldest, ..., newest)
+// in amortized O(1), for any associative op (min, max, sum, gcd, ...).
+// It is a queue made of two Stacks. New samples go on `back`; each entry also stores
+// the aggregate of itself and everything beneath it. When the oldest sample has to
+// leave and `front` is empty, `back` is poured into `front`, which reverses the order
+// and rebuilds the aggregates from the other side. The answer is then just the two
+// top aggregates combined.
+template <typename T, typename Op>
+class SlidingWindow
+{
+private:
+    struct Entry
+    {
+        T value;
+        T aggregate;
+    };
+
+    Stack<Entry> front;
+    Stack<Entry> back;
+    int window;
+    Op op;
+
+    void transfer()
+    {
+        while (!back.isEmpty())
+        {
+            T value = move(back.top().value);
+            back.pop();
+            T aggregate = front.isEmpty() ? value : op(value, front.top().aggregate);
+            front.push(Entry{move(value), move(aggregate)});
+        }
+    }
+
+public:
+    SlidingWindow(int windowSize, Op o = Op())
+        : front(windowSize), back(windowSize), window(windowSize), op(o)
+    {
+        if (windowSize < 1)
+        {
+            throw StackException("Window size must be positive");
+        }
+    }
+
+    int size() const
+    {
+        return front.size() + back.size();
+    }
+
+    bool isEmpty() const
+    {
+        return size() == 0;
+    }
+
+    // appends a sample, evicting the oldest one if the window is full
+    void push(const T &value)
+    {
+        if (size() == window)
+            pop();
+        T aggregate = back.isEmpty() ? value : op(back.top().aggregate, value);
+        back.push(Entry{value, move(aggregate)});
+    }
+
+    // drops the oldest sample
+    void pop()
+    {
+        if (front.isEmpty())
+            transfer();
+        front.pop();
+    }
+
+    T query() const
+    {
+        if (front.isEmpty() && back.isEmpty())
+        {
+            throw StackException("Stack is empty");
+        }
+        if (front.isEmpty())
+            return back.top().aggregate;
+        if (back.isEmpty())
+            return front.top().aggregate;
+        return op(front.top().aggregate, back.top().aggregate);
+    }
+
+    // pushes each sample and writes the window's aggregate after each step to results
+    void slide(const T *values, int count, T *results)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            push(values[i]);
+            results[i] = query();
+        }
+    }
+
+#if __cplusplus >= 202002L
+    void slide(span<const T> values, span<T> results)
+    {
+        slide(values.data(), (int)values.size(), results.data());
+    }
+#endif
+};
+
+#endif
@@ -0,0 +1,77 @@
+#include <iostream>
+#include <deque>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include "SlidingWindow.h"
+using namespace std;
+
+struct Min
+{
+    int operator()(int a, int b) const { return a < b ? a : b; }
+};
+
+struct Sum
+{
+    long long operator()(long long a, long long b) const { return a + b; }
+};
+
+double seconds(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// rescans the whole window for every sample after the first `window`
+long long naive(const vector<int> &samples, int window, int steps)
+{
+    deque<int> d(samples.begin(), samples.begin() + window);
+    long long check = 0;
+    for (int i = window; i < window + steps; i++)
+    {
+        d.pop_front();
+        d.push_back(samples[i]);
+        check += *min_element(d.begin(), d.end());
+    }
+    return check;
+}
+
+int main()
+{
+    mt19937 rng(7);
+    for (int window = 10; window <= 1000000; window *= 10)
+    {
+        // enough samples to fill the window a few times, without letting the rescan run for minutes
+        int n = max(4 * window, 2000000);
+        vector<int> samples(n);
+        for (int &x : samples)
+            x = (int)(rng() % 1000000);
+
+        SlidingWindow<int, Min> w(window);
+        vector<int> results(n);
+        auto start = chrono::steady_clock::now();
+        w.slide(samples.data(), n, results.data());
+        double fast = seconds(start);
+
+        // the rescan costs O(window) per sample, so only time about 1e8 comparisons of it
+        int steps = min(n - window, max(10, 100000000 / window));
+        start = chrono::steady_clock::now();
+        naive(samples, window, steps);
+        double slow = seconds(start) / steps * n;
+
+        // both must agree on every window they both saw
+        long long expected = 0;
+        for (int i = window; i < window + steps; i++)
+            expected += results[i];
+        bool ok = naive(samples, window, steps) == expected;
+
+        cout << "window " << window << ": two stacks " << n / fast / 1e6 << " M samples/s, deque rescan "
+             << n / slow / 1e6 << " M samples/s" << (ok ? "" : "  MISMATCH") << endl;
+    }
+
+    SlidingWindow<long long, Sum> sums(3);
+    for (long long x : {1, 2, 3, 4, 5})
+        sums.push(x);
+    cout << "sum of last 3 of 1..5: " << sums.query() << '\n';
+    return 0;
+}
@@ -0,0 +1,327 @@
+#ifndef SMALLSTACK_H
+#define SMALLSTACK_H
+
+#include <cstdlib>
+#include <cstring>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "StackException.h"
+
+// Stack whose first N elements live inside the object itself, so short-lived
+// stacks never touch the heap. Past N the storage doubles; elements are moved
+// across, or for trivially copyable types the buffer is simply realloc'ed.
+template <typename T, int N = 16>
+class SmallStack
+{
+private:
+    static_assert(N > 0, "inline capacity must be positive");
+
+    // realloc may only be used on malloc'ed memory holding bitwise-movable elements
+    static const bool relocatable = is_trivially_copyable<T>::value && alignof(T) <= alignof(max_align_t);
+
+    alignas(T) unsigned char inlineBuffer[N * sizeof(T)];
+    T *data;
+    int count;
+    int capacity;
+
+    bool isInline() const
+    {
+        return data == reinterpret_cast<const T *>(inlineBuffer);
+    }
+
+    T *inlineData()
+    {
+        return reinterpret_cast<T *>(inlineBuffer);
+    }
+
+    static T *allocate(int n)
+    {
+        if constexpr (relocatable)
+        {
+            void *p = malloc(n * sizeof(T));
+            if (p == nullptr)
+                throw bad_alloc();
+            return static_cast<T *>(p);
+        }
+        return allocator<T>().allocate(n);
+    }
+
+    static void deallocate(T *p, int n)
+    {
+        if constexpr (relocatable)
+            free(p);
+        else
+            allocator<T>().deallocate(p, n);
+    }
+
+    // fresh storage for newCapacity elements holding T(element(i)) for i < n; if a
+    // constructor throws, the ones already built are destroyed and the storage freed
+    template <typename F>
+    static T *build(int newCapacity, int n, F element)
+    {
+        T *newData = allocate(newCapacity);
+        int built = 0;
+        try
+        {
+            for (; built < n; built++)
+                new (&newData[built]) T(element(built));
+        }
+        catch (...)
+        {
+            for (int i = 0; i < built; i++)
+                newData[i].~T();
+            deallocate(newData, newCapacity);
+            throw;
+        }
+        return newData;
+    }
+
+    void grow(int minCapacity)
+    {
+        int newCapacity = capacity * 2;
+        if (newCapacity < minCapacity)
+            newCapacity = minCapacity;
+
+        if constexpr (relocatable)
+        {
+            if (!isInline())
+            {
+                void *p = realloc(data, newCapacity * sizeof(T));
+                if (p == nullptr)
+                    throw bad_alloc();
+                data = static_cast<T *>(p);
+            }
+            else
+            {
+                T *newData = allocate(newCapacity);
+                memcpy(static_cast<void *>(newData), data, count * sizeof(T));
+                data = newData;
+            }
+        }
+        else
+        {
+            // the old elements stay until every new one is built, so a throwing
+            // constructor leaves the stack as it was
+            T *newData = build(newCapacity, count, [this](int i) -> decltype(auto)
+                               { return move_if_noexcept(data[i]); });
+            for (int i = 0; i < count; i++)
+                data[i].~T();
+            if (!isInline())
+                deallocate(data, capacity);
+            data = newData;
+        }
+        capacity = newCapacity;
+    }
+
+    void destroyAll()
+    {
+        for (int i = 0; i < count; i++)
+            data[i].~T();
+        count = 0;
+    }
+
+    void release()
+    {
+        destroyAll();
+        if (!isInline())
+            deallocate(data, capacity);
+        data = inlineData();
+        capacity = N;
+    }
+
+public:
+    SmallStack()
+    {
+        data = inlineData();
+        count = 0;
+        capacity = N;
+    }
+
+    SmallStack(const SmallStack &s) : SmallStack()
+    {
+        reserve(s.count);
+        for (int i = 0; i < s.count; i++)
+            push(s.data[i]);
+    }
+
+    SmallStack(SmallStack &&s) noexcept(is_nothrow_move_constructible<T>::value) : SmallStack()
+    {
+        *this = move(s);
+    }
+
+    SmallStack &operator=(const SmallStack &s)
+    {
+        // built aside first, so a throwing copy leaves this stack untouched
+        if (this == &s)
+            return *this;
+        if constexpr (is_nothrow_move_constructible<T>::value)
+        {
+            SmallStack copy(s);
+            *this = move(copy);
+        }
+        else if (s.count == 0)
+            destroyAll();
+        else
+        {
+            // moving into the inline buffer could throw as well, so the copy goes to the heap
+            T *newData = build(s.count, s.count, [&s](int i) -> const T &
+                               { return s.data[i]; });
+            release();
+            data = newData;
+            count = capacity = s.count;
+        }
+        return *this;
+    }
+
+    // Inline elements have to be moved one by one; like grow() they are copied instead
+    // when T's move can throw, and a throw leaves this stack holding the ones built so far.
+    SmallStack &operator=(SmallStack &&s) noexcept(is_nothrow_move_constructible<T>::value)
+    {
+        if (this == &s)
+            return *this;
+
+        release();
+        if (!s.isInline())
+        {
+            // steal the heap buffer
+            data = s.data;
+            count = s.count;
+            capacity = s.capacity;
+            s.data = s.inlineData();
+            s.count = 0;
+            s.capacity = N;
+        }
+        else
+        {
+            for (; count < s.count; count++)
+                new (&data[count]) T(move_if_noexcept(s.data[count]));
+            s.destroyAll();
+        }
+        return *this;
+    }
+
+    ~SmallStack()
+    {
+        release();
+    }
+
+    bool isEmpty() const
+    {
+        return count == 0;
+    }
+
+    int size() const
+    {
+        return count;
+    }
+
+    int getCapacity() const
+    {
+        return capacity;
+    }
+
+    void reserve(int n)
+    {
+        if (n > capacity)
+            grow(n);
+    }
+
+    template <typename... Args>
+    T &emplace(Args &&...args)
+    {
+        T *slot;
+        if (count == capacity)
+        {
+            // the arguments may refer into this stack, so build the element before the storage moves
+            T value(forward<Args>(args)...);
+            grow(count + 1);
+            slot = new (&data[count]) T(move(value));
+        }
+        else
+        {
+            slot = new (&data[count]) T(forward<Args>(args)...);
+        }
+        count++;
+        return *slot;
+    }
+
+    void push(const T &value)
+    {
+        emplace(value);
+    }
+
+    void push(T &&value)
+    {
+        emplace(move(value));
+    }
+
+    bool try_pop()
+    {
+        if (isEmpty())
+            return false;
+        count--;
+        data[count].~T();
+        return true;
+    }
+
+    bool try_pop(T &out)
+    {
+        if (isEmpty())
+            return false;
+        out = move(data[count - 1]);
+        return try_pop();
+    }
+
+    bool try_top(T &out) const
+    {
+        if (isEmpty())
+            return false;
+        out = data[count - 1];
+        return true;
+    }
+
+    void pop()
+    {
+        if (!try_pop())
+        {
+            throw StackException("Stack is empty");
+        }
+    }
+
+    T &top()
+    {
+        if (isEmpty())
+        {
+            throw StackException("Stack is empty");
+        }
+        return data[count - 1];
+    }
+
+    const T &top() const
+    {
+        if (isEmpty())
+        {
+            throw StackException("Stack is empty");
+        }
+        return data[count - 1];
+    }
+
+    void clear()
+    {
+        destroyAll();
+    }
+
+    void print() const
+    {
+        for (int i = count - 1; i >= 0; i--)
+        {
+            cout << data[i] << " ";
+        }
+        cout << endl;
+    }
+};
+
+#endif
@@ -0,0 +1,149 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include "Stack.h"
+#include "SmallStack.h"
+using namespace std;
+
+double seconds(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int precedence(char op)
+{
+    if (op == '*' || op == '/')
+        return 2;
+    if (op == '+' || op == '-')
+        return 1;
+    return 0;
+}
+
+// shunting-yard over one expression with a fresh operator stack, like infixToPostfix
+template <typename S>
+int toPostfixLength(const string &infix)
+{
+    S s;
+    int length = 0;
+    for (char ch : infix)
+    {
+        if (isdigit(ch))
+            length++;
+        else if (ch == '(')
+            s.push(ch);
+        else if (ch == ')')
+        {
+            while (!s.isEmpty() && s.top() != '(')
+            {
+                length++;
+                s.pop();
+            }
+            s.pop();
+        }
+        else
+        {
+            while (!s.isEmpty() && precedence(s.top()) >= precedence(ch))
+            {
+                length++;
+                s.pop();
+            }
+            s.push(ch);
+        }
+    }
+    return length + s.size();
+}
+
+string randomExpression(mt19937 &rng, int depth)
+{
+    if (depth == 0 || rng() % 3 == 0)
+        return string(1, (char)('0' + rng() % 10));
+    const char ops[] = "+-*/";
+    string e = randomExpression(rng, depth - 1) + ops[rng() % 4] + randomExpression(rng, depth - 1);
+    return rng() % 2 ? "(" + e + ")" : e;
+}
+
+// iterative DFS over one small tree stored as child lists
+template <typename S>
+long long dfs(const vector<vector<int>> &children, int root)
+{
+    S s;
+    long long visited = 0;
+    s.push(root);
+    while (!s.isEmpty())
+    {
+        int node = s.top();
+        s.pop();
+        visited += node;
+        for (int c : children[node])
+            s.push(c);
+    }
+    return visited;
+}
+
+template <typename S>
+void runExpressions(const char *name, const vector<string> &exprs)
+{
+    long long total = 0;
+    auto start = chrono::steady_clock::now();
+    for (int round = 0; round < 20; round++)
+        for (const string &e : exprs)
+            total += toPostfixLength<S>(e);
+    cout << "  " << name << ": " << seconds(start) << " s (" << total << ")\n";
+}
+
+template <typename S>
+void runDfs(const char *name, const vector<vector<int>> &children, const vector<int> &roots)
+{
+    long long total = 0;
+    auto start = chrono::steady_clock::now();
+    for (int round = 0; round < 20; round++)
+        for (int r : roots)
+            total += dfs<S>(children, r);
+    cout << "  " << name << ": " << seconds(start) << " s (" << total << ")\n";
+}
+
+// vector wrapped in the Stack interface, as the usual growable alternative
+template <typename T>
+struct VectorStack
+{
+    vector<T> v;
+    void push(const T &x) { v.push_back(x); }
+    void pop() { v.pop_back(); }
+    T top() const { return v.back(); }
+    bool isEmpty() const { return v.empty(); }
+    int size() const { return (int)v.size(); }
+};
+
+int main()
+{
+    mt19937 rng(42);
+    vector<string> exprs(200000);
+    for (string &e : exprs)
+        e = randomExpression(rng, 4);
+
+    cout << "expression parsing, " << exprs.size() << " expressions x 20:\n";
+    runExpressions<Stack<char>>("Stack<char>(100)", exprs);
+    runExpressions<VectorStack<char>>("vector<char>    ", exprs);
+    runExpressions<SmallStack<char, 16>>("SmallStack<16>  ", exprs);
+
+    // a forest of small random trees, 3 to 40 nodes each
+    vector<vector<int>> children;
+    vector<int> roots;
+    while (children.size() < 1000000)
+    {
+        int base = (int)children.size();
+        int n = 3 + rng() % 38;
+        children.resize(base + n);
+        for (int i = 1; i < n; i++)
+            children[base + rng() % i].push_back(base + i);
+        roots.push_back(base);
+    }
+
+    cout << "DFS over " << roots.size() << " small trees x 20:\n";
+    runDfs<Stack<int>>("Stack<int>(100)", children, roots);
+    runDfs<VectorStack<int>>("vector<int>    ", children, roots);
+    runDfs<SmallStack<int, 16>>("SmallStack<16> ", children, roots);
+    return 0;
+}
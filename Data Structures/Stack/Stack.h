@@ -1,7 +1,14 @@
+#ifndef STACK_H
+#define STACK_H
+
 #include <iostream>
+#include <memory>
+#include <new>
+#include <utility>
 #include "StackException.h"
 using namespace std;
 
+// Storage is left uninitialized; a slot holds an object only while it is on the stack.
 template <typename T>
 class Stack
 {
@@ -10,17 +17,86 @@ private:
     int topIndex;
     T *data;
 
+    void destroyAll()
+    {
+        while (topIndex >= 0)
+        {
+            data[topIndex].~T();
+            topIndex--;
+        }
+    }
+
 public:
     Stack(int size = 100)
     {
         capacity = size;
         topIndex = -1;
-        data = new T[capacity];
+        data = allocator<T>().allocate(capacity);
+    }
+
+    Stack(const Stack &s)
+    {
+        capacity = s.capacity;
+        topIndex = -1;
+        data = allocator<T>().allocate(capacity);
+        try
+        {
+            for (int i = 0; i <= s.topIndex; i++)
+            {
+                new (&data[i]) T(s.data[i]);
+                topIndex = i;
+            }
+        }
+        catch (...)
+        {
+            destroyAll();
+            allocator<T>().deallocate(data, capacity);
+            throw;
+        }
+    }
+
+    Stack(Stack &&s) noexcept
+    {
+        capacity = s.capacity;
+        topIndex = s.topIndex;
+        data = s.data;
+        s.capacity = 0;
+        s.topIndex = -1;
+        s.data = nullptr;
+    }
+
+    Stack &operator=(const Stack &s)
+    {
+        if (this != &s)
+        {
+            Stack copy(s);
+            *this = move(copy);
+        }
+        return *this;
+    }
+
+    Stack &operator=(Stack &&s) noexcept
+    {
+        if (this != &s)
+        {
+            destroyAll();
+            if (data != nullptr)
+                allocator<T>().deallocate(data, capacity);
+            capacity = s.capacity;
+            topIndex = s.topIndex;
+            data = s.data;
+            s.capacity = 0;
+            s.topIndex = -1;
+            s.data = nullptr;
+        }
+        return *this;
     }
 
     ~Stack()
     {
-        delete[] data;
+        destroyAll();
+        if (data != nullptr)
+            allocator<T>().deallocate(data, capacity);
     }
 
     bool isFull() const
@@ -33,24 +109,96 @@ public:
         return topIndex == -1;
     }
 
-    void push(const T &value)
+    // non-throwing variants: false means the stack was full (push) or empty
+    template <typename... Args>
+    bool try_emplace(Args &&...args)
     {
         if (isFull())
+            return false;
+        new (&data[topIndex + 1]) T(forward<Args>(args)...);
+        topIndex++;
+        return true;
+    }
+
+    bool try_push(const T &value)
+    {
+        return try_emplace(value);
+    }
+
+    bool try_push(T &&value)
+    {
+        return try_emplace(move(value));
+    }
+
+    bool try_pop()
+    {
+        if (isEmpty())
+            return false;
+        data[topIndex].~T();
+        topIndex--;
+        return true;
+    }
+
+    bool try_pop(T &out)
+    {
+        if (isEmpty())
+            return false;
+        out = move(data[topIndex]);
+        return try_pop();
+    }
+
+    bool try_top(T &out) const
+    {
+        if (isEmpty())
+            return false;
+        out = data[topIndex];
+        return true;
+    }
+
+    template <typename... Args>
+    T &emplace(Args &&...args)
+    {
+        if (!try_emplace(forward<Args>(args)...))
         {
             throw StackException("Stack is full");
         }
-        topIndex++;
-        data[topIndex] = value;
+        return data[topIndex];
+    }
+
+    void push(const T &value)
+    {
+        emplace(value);
+    }
+
+    void push(T &&value)
+    {
+        emplace(move(value));
     }
 
     void pop() {
+        if (!try_pop()) {
+            throw StackException("Stack is empty");
+        }
+    }
+
+    // moves the top element out and pops it
+    T pop_value() {
         if (isEmpty()) {
             throw StackException("Stack is empty");
         }
-        topIndex--;
+        T value(move(data[topIndex]));
+        try_pop();
+        return value;
+    }
+
+    T &top() {
+        if (isEmpty()) {
+            throw StackException("Stack is empty");
+        }
+        return data[topIndex];
     }
 
-    T top() const {
+    const T &top() const {
         if (isEmpty()) {
             throw StackException("Stack is empty");
         }
@@ -71,3 +219,5 @@ public:
         cout << endl;
     }
 };
+
+#endif
@@ -1,6 +1,7 @@
 #include <iostream>
-#include <math.h>
-#include "stack.h"
+#include "Stack.h"
+#include "Expression.h"
+#include "BigInt.h"
 using namespace std;
 
 bool isOperator(char c)
@@ -23,14 +24,20 @@ string infixToPostfix(const string &infix)
 {
     Stack<char> s;
     string postfix;
+    bool inOperand = false;
 
     for (char ch : infix)
     {
+        bool continues = inOperand;
+        inOperand = isalnum(ch);
         if (isspace(ch))
             continue;
 
         if (isalnum(ch))
         {
+            // operands are separated by spaces so multi-digit numbers survive
+            if (!continues && !postfix.empty())
+                postfix += ' ';
             postfix += ch;
         }
         else if (ch == '(')
@@ -41,6 +48,7 @@ string infixToPostfix(const string &infix)
         {
             while (!s.isEmpty() && s.top() != '(')
             {
+                postfix += ' ';
                 postfix += s.top();
                 s.pop();
             }
@@ -49,8 +57,11 @@ string infixToPostfix(const string &infix)
         }
         else if (isOperator(ch))
         {
-            while (!s.isEmpty() && precedence(s.top()) >= precedence(ch))
+            // '^' is right-associative: 2 ^ 3 ^ 2 is 2 ^ (3 ^ 2)
+            while (!s.isEmpty() && (precedence(s.top()) > precedence(ch) ||
+                                    (precedence(s.top()) == precedence(ch) && ch != '^')))
             {
+                postfix += ' ';
                 postfix += s.top();
                 s.pop();
             }
@@ -60,6 +71,7 @@ string infixToPostfix(const string &infix)
 
     while (!s.isEmpty())
     {
+        postfix += ' ';
         postfix += s.top();
         s.pop();
     }
@@ -67,29 +79,38 @@ string infixToPostfix(const string &infix)
     return postfix;
 }
 
-int evaluate(int op1, int op2, char oper) {
+// int, long long, double or BigInt; the integer types throw on overflow
+template <typename Number>
+Number evaluate(const Number &op1, const Number &op2, char oper) {
+    typedef NumberTraits<Number> Traits;
     switch (oper) {
-        case '+': return op1 + op2;
-        case '-': return op1 - op2;
-        case '*': return op1 * op2;
-        case '/': return op1 / op2;
-        case '^': return pow(op1, op2);
+        case '+': return Traits::add(op1, op2);
+        case '-': return Traits::subtract(op1, op2);
+        case '*': return Traits::multiply(op1, op2);
+        case '/': return Traits::divide(op1, op2);
+        case '^': return Traits::power(op1, op2);
         default: throw runtime_error("Invalid operator");
     }
 }
 
-int evaluatePostfix(const string& postfix) {
-    Stack<int> s;
-    for (char ch : postfix) {
+template <typename Number = int>
+Number evaluatePostfix(const string& postfix) {
+    Stack<Number> s;
+    for (size_t i = 0; i < postfix.size(); i++) {
+        char ch = postfix[i];
         if (isspace(ch)) continue;
 
         if (isdigit(ch)) {
-            s.push(ch - '0'); 
+            size_t start = i;
+            while (i < postfix.size() && isdigit(postfix[i]))
+                i++;
+            s.push(NumberTraits<Number>::fromLiteral(postfix.substr(start, i - start)));
+            i--;
         } else if (isOperator(ch)) {
             if (s.size() < 2) throw runtime_error("Invalid expression");
-            int op2 = s.top(); s.pop();
-            int op1 = s.top(); s.pop();
-            int result = evaluate(op1, op2, ch);
+            Number op2 = s.pop_value();
+            Number op1 = s.pop_value();
+            Number result = evaluate(op1, op2, ch);
             s.push(result);
         } else {
             throw runtime_error(string("Invalid character: ") + ch);
@@ -105,12 +126,37 @@ int main()
     // postfix => 3 8 2 * +
     // prefix => + 3 * 8 2
 
-    string infix = "3 + 8 * 2 + ( 6 / 2 ) * 7";
+    string infix = "3 + 8 * 2 + ( 6 / 2 ) * 7 + 2 ^ 3 ^ 2 - 100";
     string postfix = infixToPostfix(infix);
     cout << "Infix: " << infix << endl;
     cout << "Postfix: " << postfix << endl;
 
     cout << evaluatePostfix(postfix) << endl;
 
+    // 2 ^ 40 no longer fits an int: checked, it throws instead of wrapping
+    string big = infixToPostfix("2 ^ 40 + 7 ^ 20");
+    try
+    {
+        cout << evaluatePostfix<int>(big) << endl;
+    }
+    catch (const runtime_error &e)
+    {
+        cout << "int: " << e.what() << endl;
+    }
+    cout << "long long: " << evaluatePostfix<long long>(big) << endl;
+    cout << "BigInt: " << evaluatePostfix<BigInt>(infixToPostfix("2 ^ 40 * 7 ^ 30 ^ 2")) << endl;
+
+    // compiled once, evaluated for every binding without re-parsing
+    Expression e = Expression::compile("price * (1 + rate) ^ years - 2 ^ 3 ^ 2");
+    cout << "Bytecode: " << e.postfix() << endl;
+    double values[3];
+    values[e.variable("price")] = 100;
+    values[e.variable("rate")] = 0.05;
+    for (int years = 0; years <= 3; years++)
+    {
+        values[e.variable("years")] = years;
+        cout << e.evaluate(values) << endl;
+    }
+
     return 0;
 }
\ No newline at end of file
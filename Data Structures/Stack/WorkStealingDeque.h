@@ -0,0 +1,164 @@
+#ifndef WORKSTEALINGDEQUE_H
+#define WORKSTEALINGDEQUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "StackException.h"
+
+// Chase-Lev work-stealing deque (with the C11 orderings of Le, Pop, Cohen and
+// Zappa Nardelli, 2013). The owning thread pushes and pops at the bottom like a
+// Stack; any number of thieves take from the top with a CAS. The ring grows when
+// the owner runs out of room. Replaced rings are kept until the deque is destroyed
+// because a thief may still be reading from one.
+//
+// The standalone fences of the paper are folded into seq_cst operations on top and
+// bottom: the same guarantees, and ThreadSanitizer understands them.
+template <typename T>
+class WorkStealingDeque
+{
+private:
+    static_assert(is_trivially_copyable<T>::value, "slots are read racily by thieves, so T must be trivially copyable");
+
+    struct Ring
+    {
+        int64_t capacity;
+        int64_t mask;
+        atomic<T> *slots;
+
+        Ring(int64_t c) : capacity(c), mask(c - 1), slots(new atomic<T>[c]) {}
+
+        ~Ring()
+        {
+            delete[] slots;
+        }
+
+        void put(int64_t i, const T &value)
+        {
+            slots[i & mask].store(value, memory_order_relaxed);
+        }
+
+        T get(int64_t i) const
+        {
+            return slots[i & mask].load(memory_order_relaxed);
+        }
+    };
+
+    alignas(64) atomic<int64_t> top;
+    alignas(64) atomic<int64_t> bottom;
+    atomic<Ring *> ring;
+    vector<Ring *> retired; // owner only
+
+    Ring *grow(Ring *old, int64_t b, int64_t t)
+    {
+        Ring *bigger = new Ring(old->capacity * 2);
+        for (int64_t i = t; i < b; i++)
+            bigger->put(i, old->get(i));
+        retired.push_back(old);
+        ring.store(bigger, memory_order_release);
+        return bigger;
+    }
+
+public:
+    WorkStealingDeque(int initialCapacity = 64)
+    {
+        int64_t c = 1;
+        while (c < initialCapacity)
+            c <<= 1;
+        top.store(0, memory_order_relaxed);
+        bottom.store(0, memory_order_relaxed);
+        ring.store(new Ring(c), memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque &) = delete;
+    WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+    ~WorkStealingDeque()
+    {
+        delete ring.load(memory_order_relaxed);
+        for (Ring *r : retired)
+            delete r;
+    }
+
+    // owner only
+    void push(const T &value)
+    {
+        int64_t b = bottom.load(memory_order_relaxed);
+        int64_t t = top.load(memory_order_acquire);
+        Ring *r = ring.load(memory_order_relaxed);
+        if (b - t > r->capacity - 1)
+            r = grow(r, b, t);
+        r->put(b, value);
+        bottom.store(b + 1, memory_order_release);
+    }
+
+    // owner only: takes the most recently pushed element
+    bool try_pop(T &out)
+    {
+        int64_t b = bottom.load(memory_order_relaxed) - 1;
+        Ring *r = ring.load(memory_order_relaxed);
+        bottom.store(b, memory_order_seq_cst);
+        int64_t t = top.load(memory_order_seq_cst);
+
+        if (t > b)
+        {
+            // already empty
+            bottom.store(b + 1, memory_order_relaxed);
+            return false;
+        }
+
+        T value = r->get(b);
+        if (t == b)
+        {
+            // last element: race the thieves for it
+            bool won = top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+            bottom.store(b + 1, memory_order_relaxed);
+            if (!won)
+                return false;
+        }
+        out = value;
+        return true;
+    }
+
+    // any thread: takes the oldest element; false if empty or another thief won the race
+    bool try_steal(T &out)
+    {
+        int64_t t = top.load(memory_order_seq_cst);
+        int64_t b = bottom.load(memory_order_seq_cst);
+        if (t >= b)
+            return false;
+
+        Ring *r = ring.load(memory_order_acquire);
+        T value = r->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed))
+            return false;
+        out = value;
+        return true;
+    }
+
+    T pop()
+    {
+        T value;
+        if (!try_pop(value))
+        {
+            throw StackException("Stack is empty");
+        }
+        return value;
+    }
+
+    // approximate unless called by the owner with no thieves running
+    int size() const
+    {
+        int64_t b = bottom.load(memory_order_relaxed);
+        int64_t t = top.load(memory_order_relaxed);
+        return b > t ? (int)(b - t) : 0;
+    }
+
+    bool isEmpty() const
+    {
+        return size() == 0;
+    }
+};
+
+#endif
@@ -0,0 +1,105 @@
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include "WorkStealingDeque.h"
+using namespace std;
+
+int tasks = 10000000;
+
+double seconds(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// owner pushes and pops in LIFO bursts, nobody steals
+void ownerOnly()
+{
+    WorkStealingDeque<int> d(16);
+    long long sum = 0;
+    int value;
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < tasks; i += 64)
+    {
+        for (int k = 0; k < 64; k++)
+            d.push(i + k);
+        while (d.try_pop(value))
+            sum += value;
+    }
+    double t = seconds(start);
+    cout << "owner only:      " << tasks / t / 1e6 << " M tasks/s" << (sum >= 0 ? "" : " ") << '\n';
+}
+
+// owner keeps pushing and occasionally pops, thieves steal everything they can;
+// every task must be taken exactly once
+void heavySteal(int thieves)
+{
+    WorkStealingDeque<int> d(16);
+    vector<atomic<unsigned char>> seen(tasks);
+    for (auto &s : seen)
+        s.store(0, memory_order_relaxed);
+    atomic<bool> done(false);
+    atomic<long long> stolen(0);
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> pool;
+    for (int i = 0; i < thieves; i++)
+    {
+        pool.emplace_back([&]()
+                          {
+            int value;
+            long long mine = 0;
+            while (true)
+            {
+                if (d.try_steal(value))
+                {
+                    seen[value].fetch_add(1, memory_order_relaxed);
+                    mine++;
+                }
+                else if (done.load(memory_order_acquire) && d.isEmpty())
+                    break;
+                else
+                    this_thread::yield();
+            }
+            stolen.fetch_add(mine); });
+    }
+
+    int value;
+    for (int i = 0; i < tasks; i++)
+    {
+        d.push(i);
+        if (i % 4 == 0 && d.try_pop(value))
+            seen[value].fetch_add(1, memory_order_relaxed);
+    }
+    while (d.try_pop(value))
+        seen[value].fetch_add(1, memory_order_relaxed);
+    done.store(true, memory_order_release);
+    for (thread &t : pool)
+        t.join();
+    double t = seconds(start);
+
+    bool ok = true;
+    for (auto &s : seen)
+        ok = ok && s.load() == 1;
+    cout << "heavy steal, " << thieves << " thieves: " << tasks / t / 1e6 << " M tasks/s, "
+         << stolen.load() * 100.0 / tasks << "% stolen" << (ok ? "" : "  LOST OR DUPLICATED TASKS") << '\n';
+}
+
+int main(int argc, char *argv[])
+{
+    int maxThieves = (int)thread::hardware_concurrency() - 1;
+    if (argc > 1)
+        maxThieves = atoi(argv[1]);
+    if (argc > 2)
+        tasks = atoi(argv[2]);
+    if (maxThieves < 1)
+        maxThieves = 1;
+
+    ownerOnly();
+    for (int n = 1; n <= maxThieves; n *= 2)
+        heavySteal(n);
+    return 0;
+}